@@ -2,6 +2,7 @@
 #define LDP_ABSTR_ROUTER_H
 #include "abstraction/interface.hh"
 #include "abstraction/route.hh"
+#include "abstraction/prefix.hh"
 #include <vector>
 #include <map>
 
@@ -21,11 +22,20 @@ public:
     virtual std::vector<const Route *> getFib() = 0;
     virtual std::vector<const Route *> getRoutes() = 0;
 
+    // point lookups in the routes added w/ addRoute(): the route to exactly
+    // the given prefix / for the given in label, or nullptr if there is none.
+    virtual const Ipv4Route* findIpv4Route(const Prefix &prefix) = 0;
+    virtual const MplsRoute* findMplsRoute(uint32_t label) = 0;
+
     virtual uint64_t addRoute(Route *route) = 0;
     virtual bool deleteRoute(const Route *selector) = 0;
 
     virtual void onRouteChange(void *data, ldp_routechange_handler_t handler) = 0;
 
+    // fd that becomes readable when there are route changes to process (call
+    // tick() then), or -1 if the router has nothing to wait on.
+    virtual int getFd() const = 0;
+
     virtual void tick() = 0;
 };
 
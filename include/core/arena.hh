@@ -0,0 +1,126 @@
+#ifndef LDP_ARENA_H
+#define LDP_ARENA_H
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <new>
+#include <vector>
+
+// everything handed out by the arena is aligned to this.
+#define LDP_ARENA_ALIGN 16
+
+// size of the blocks the arena carves allocations from. allocations bigger
+// than a quarter of this get a block of their own.
+#define LDP_ARENA_BLOCK_SIZE 65536
+
+namespace ldpd {
+
+/**
+ * @brief bump allocator.
+ *
+ * allocations are carved off the current block and are never freed one by
+ * one - reset() gives everything back at once and keeps the blocks for
+ * reuse. meant for the objects of a single pdu, which all die together.
+ *
+ * note: objects living in the arena must be destroyed before reset().
+ *
+ * a copy is a new, empty arena.
+ */
+class Arena {
+public:
+    Arena();
+    Arena(const Arena &);
+    ~Arena();
+
+    void* allocate(size_t size);
+
+    void reset();
+    void release();
+
+    size_t used() const;
+    size_t capacity() const;
+
+private:
+    Arena& operator=(const Arena &);
+
+    struct Block {
+        uint8_t *data;
+        size_t size;
+    };
+
+    void* allocateLarge(size_t size);
+
+    // regular blocks, reused after reset. _current is the one being carved.
+    std::vector<Block> _blocks;
+    size_t _current;
+    size_t _offset;
+
+    // blocks for large allocations, freed on reset.
+    std::vector<Block> _large;
+
+    size_t _used;
+};
+
+/**
+ * @brief base for objects that may be allocated from an arena.
+ *
+ * `new X()` allocates from the heap as usual, `new (arena) X()` from the
+ * arena (or from the heap if arena is nullptr). `delete` works on both -
+ * heap memory is freed, arena memory is left for Arena::reset() - so owners
+ * do not need to know where an object came from.
+ */
+class ArenaObject {
+public:
+    static void* operator new(size_t size);
+    static void* operator new(size_t size, Arena *arena);
+
+    static void operator delete(void *ptr);
+    static void operator delete(void *ptr, Arena *arena);
+};
+
+/**
+ * @brief allocator for standard containers. allocates from the arena, or
+ * from the heap if arena is nullptr.
+ */
+template <typename T> class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    ArenaAllocator(Arena *arena = nullptr) : _arena(arena) {}
+    template <typename U> ArenaAllocator(const ArenaAllocator<U> &other) : _arena(other.getArena()) {}
+
+    T* allocate(size_t n) {
+        void *ptr = _arena != nullptr ? _arena->allocate(n * sizeof(T)) : malloc(n * sizeof(T));
+
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+
+        return (T *) ptr;
+    }
+
+    void deallocate(T *ptr, size_t) {
+        if (_arena == nullptr) {
+            free(ptr);
+        }
+    }
+
+    Arena* getArena() const {
+        return _arena;
+    }
+
+    template <typename U> bool operator==(const ArenaAllocator<U> &other) const {
+        return _arena == other.getArena();
+    }
+
+    template <typename U> bool operator!=(const ArenaAllocator<U> &other) const {
+        return _arena != other.getArena();
+    }
+
+private:
+    Arena *_arena;
+};
+
+}
+
+#endif // LDP_ARENA_H
@@ -0,0 +1,37 @@
+#ifndef LDP_FEC_QUEUE_H
+#define LDP_FEC_QUEUE_H
+#include "abstraction/prefix.hh"
+#include "core/mapping-db.hh"
+#include <stddef.h>
+#include <deque>
+#include <unordered_set>
+
+namespace ldpd {
+
+/**
+ * @brief fifo of fecs w/o duplicates: pushing a fec that is already queued
+ * does nothing, so a fec that changes many times between two refreshes is
+ * only looked at once.
+ */
+class FecQueue {
+public:
+    FecQueue();
+
+    bool push(const Prefix &fec);
+    const Prefix& front() const;
+    void pop();
+
+    bool contains(const Prefix &fec) const;
+    bool empty() const;
+    size_t size() const;
+
+    void clear();
+
+private:
+    std::deque<Prefix> _queue;
+    std::unordered_set<Prefix, PrefixHash> _queued;
+};
+
+}
+
+#endif // LDP_FEC_QUEUE_H
@@ -0,0 +1,74 @@
+#ifndef LDP_LABEL_ALLOCATOR_H
+#define LDP_LABEL_ALLOCATOR_H
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+
+// labels 0 - 15 are reserved (rfc 3032), labels are 20 bits.
+#define LDP_MIN_LBL 16
+#define LDP_MAX_LBL 1048575
+
+// returned when no label is left.
+#define LDP_LABEL_NONE 0xffffffff
+
+namespace ldpd {
+
+/**
+ * @brief hands out labels from a range, lowest free label first.
+ *
+ * free labels are kept in a bitmap, w/ a summary bitmap on top of it (a bit
+ * per word of the level below, set if that word has a free label), and so
+ * on up to a single word. allocate() follows the lowest set bit down from
+ * the top, release() sets the bit and the summary bits above it - both in
+ * a fixed number of steps (4 for the full 20-bit label space).
+ *
+ * blocks of labels can be reserved for others (e.g. static lsps, other
+ * label distribution protocols); they are never handed out.
+ */
+class LabelAllocator {
+public:
+    LabelAllocator(uint32_t min = LDP_MIN_LBL, uint32_t max = LDP_MAX_LBL);
+
+    uint32_t allocate();
+    int release(uint32_t label);
+
+    int reserve(uint32_t first, uint32_t count);
+    int unreserve(uint32_t first, uint32_t count);
+
+    bool used(uint32_t label) const;
+
+    uint32_t getMinLabel() const;
+    uint32_t getMaxLabel() const;
+
+    size_t allocated() const;
+    size_t available() const;
+
+private:
+    struct Block {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    void markUsed(size_t index);
+    void markFree(size_t index);
+
+    const Block* findReserved(uint32_t label) const;
+
+    uint32_t _min;
+    uint32_t _max;
+
+    // _levels[0] has a bit per label (label - _min), set if free. each level
+    // above has a bit per word of the level below, set if the word is not 0.
+    // the last level is a single word.
+    std::vector<std::vector<uint64_t>> _levels;
+
+    std::vector<Block> _reserved;
+
+    // labels handed out by allocate(), and labels free.
+    size_t _allocated;
+    size_t _free;
+};
+
+}
+
+#endif // LDP_LABEL_ALLOCATOR_H
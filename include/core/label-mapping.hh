@@ -2,10 +2,19 @@
 #define LDP_LBL_MAPPING_H
 #include "abstraction/prefix.hh"
 #include <stdint.h>
+#include <stddef.h>
 #include <vector>
+#include <unordered_set>
 
 namespace ldpd {
 
+/**
+ * @brief a label binding.
+ *
+ * a binding is identified by its fec and direction (remote or local): there
+ * is at most one of each per peer, so that is what == and < compare. labels
+ * and the hidden flag are not part of the identity.
+ */
 struct LdpLabelMapping {
     LdpLabelMapping();
 
@@ -20,6 +29,13 @@ struct LdpLabelMapping {
     Prefix fec;
 };
 
+// hash of the identity of a binding (fec and direction), consistent w/ ==.
+struct LdpLabelMappingHash {
+    size_t operator()(const LdpLabelMapping &mapping) const;
+};
+
+typedef std::unordered_set<LdpLabelMapping, LdpLabelMappingHash> LdpLabelMappingSet;
+
 }
 
 #endif // LDP_LBL_MAPPING_H
\ No newline at end of file
@@ -1,20 +1,67 @@
 #ifndef LDP_LDPD
 #define LDP_LDPD
 #include "ldp-message/ldp-message.hh"
+#include "ldp-message/ldp-message-view.hh"
+#include "ldp-pdu/ldp-pdu-writer.hh"
+#include "ldp-fsm/ldp-pdu-packer.hh"
 #include "abstraction/router.hh"
 #include "ldp-tlv/ldp-tlv.hh"
 #include "core/label-mapping.hh"
+#include "core/mapping-db.hh"
+#include "core/fec-queue.hh"
+#include "core/label-allocator.hh"
 #include "core/filter.hh"
+#include "core/timer-wheel.hh"
+#include "core/arena.hh"
+#include "utils/log-limiter.hh"
+#include "sysdep/linux/epoll.hh"
+#include "sysdep/linux/clock.hh"
 #include <time.h>
 #include <stdint.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
 #include <map>
 #include <set>
 
 #define LDP_TCP_BACKLOG 16
-#define LDP_MIN_LBL 16
-#define LDP_MAX_LBL 1048576
 #define LDP_PORT 646
 
+#define LDP_EPOLL_BATCH 64
+
+// max work done for each source on a single wakeup. whatever is left over is
+// picked up on the next wakeup, after everyone else got their turn.
+#define LDP_ACCEPT_BUDGET 16
+#define LDP_HELLO_BUDGET 64
+#define LDP_SESSION_READ_BUDGET 4
+
+// hellos read by a single recvmmsg(), and the room we have for each.
+#define LDP_HELLO_BATCH 32
+#define LDP_HELLO_BUFFER_SIZE 4096
+#define LDP_HELLO_CONTROL_SIZE 128
+
+// offset of the message id in an encoded hello pdu (pdu header, message type
+// and length before it).
+#define LDP_HELLO_MSGID_OFFSET 14
+
+// all times below are in milliseconds unless noted.
+
+// time a single non-blocking connect may take before it is given up.
+#define LDP_CONNECT_TIMEOUT 10000
+
+// delay before retrying a failed connect; doubles on every failure (rfc5036
+// 2.5.3 suggests starting at 15s and going no higher than 2 minutes).
+#define LDP_CONNECT_BACKOFF_INIT 15000
+#define LDP_CONNECT_BACKOFF_MAX 120000
+
+// time between mapping refreshes / route pushes.
+#define LDP_HOUSEKEEPING_INTERVAL 1000
+
+#define LDP_DEF_HELLO_INTERVAL 5000
+#define LDP_DEF_LINK_HOLD 15000
+#define LDP_DEF_KEEPALIVE 45 // seconds, as negotiated on the wire.
+#define LDP_DEF_IFSCAN_INTERVAL 300000
+
+// hold times in hellos are in seconds. 0 there means the default below.
 #define LDP_DEF_HELLO_HOLD 15
 #define LDP_DEF_THELLO_HOLD 45
 
@@ -23,6 +70,90 @@
 namespace ldpd {
 
 class LdpFsm;
+class Ldpd;
+
+// a hello adjacency. the hold timer removes it when no hello was received
+// for the hold time.
+struct LdpAdjacency {
+    LdpAdjacency() {
+        ldpd = nullptr;
+        key = 0;
+        last_hello = 0;
+    }
+
+    Ldpd *ldpd;
+    uint64_t key;
+    uint64_t last_hello;
+    Timer hold;
+};
+
+// buffers for receiving a batch of hellos with recvmmsg(), allocated once.
+struct LdpHelloBatch {
+    LdpHelloBatch();
+
+    struct mmsghdr msgs[LDP_HELLO_BATCH];
+    struct iovec iovs[LDP_HELLO_BATCH];
+    struct sockaddr_in remotes[LDP_HELLO_BATCH];
+    uint8_t controls[LDP_HELLO_BATCH][LDP_HELLO_CONTROL_SIZE];
+    uint8_t buffers[LDP_HELLO_BATCH][LDP_HELLO_BUFFER_SIZE];
+};
+
+// a non-blocking connect in progress.
+struct LdpConnect {
+    LdpConnect() {
+        ldpd = nullptr;
+        fd = -1;
+    }
+
+    Ldpd *ldpd;
+    int fd;
+    Timer timeout;
+};
+
+// counters for the event loop dispatcher. *_budget_hits is incremented every
+// time a source still had work to do after using up its budget.
+struct LdpdDispatchStats {
+    LdpdDispatchStats() {
+        wakeups = 0;
+        accept_budget_hits = 0;
+        hello_budget_hits = 0;
+        session_budget_hits = 0;
+    }
+
+    uint64_t wakeups;
+    uint64_t accept_budget_hits;
+    uint64_t hello_budget_hits;
+    uint64_t session_budget_hits;
+};
+
+// connect retry state of a neighbor.
+struct LdpConnectBackoff {
+    LdpConnectBackoff() {
+        delay = 0;
+        next = 0;
+    }
+
+    // current delay, 0 if the last attempt did not fail.
+    uint32_t delay;
+
+    // no new attempt before this time.
+    uint64_t next;
+};
+
+// what the packer callbacks of Ldpd need to encode a label mapping / address
+// message.
+struct LdpMappingAdvertisement {
+    Ldpd *ldpd;
+    const LdpLabelMapping *mapping;
+};
+
+struct LdpAddressAdvertisement {
+    Ldpd *ldpd;
+    std::vector<uint32_t> addresses;
+
+    // first address not yet encoded.
+    size_t next;
+};
 
 class Ldpd {
 public:
@@ -45,17 +176,28 @@ public:
     uint16_t getLabelSpace() const;
     uint32_t getTransportAddress() const;
     uint16_t getKeepaliveTime() const;
+    uint16_t getMaxPduLength() const;
 
     uint32_t getNextMessageId();
 
     void setTransportAddress(uint32_t address);
     void setKeepaliveTimer(uint16_t timer);
+    void setMaxPduLength(uint16_t length);
+    void setHelloInterval(uint32_t interval);
+    void setHelloHoldTime(uint32_t hold);
+
+    int setLabelRange(uint32_t min, uint32_t max);
+    int reserveLabels(uint32_t first, uint32_t count);
+    int unreserveLabels(uint32_t first, uint32_t count);
 
-    ssize_t transmit(LdpFsm* by, const uint8_t *buffer, size_t len);
-    ssize_t handleMessage(LdpFsm* from, const LdpMessage *msg);
+    int scheduleFlush(LdpFsm* by);
+    ssize_t handleMessage(LdpFsm* from, const LdpMessageView &msg);
+    void reportParseError(const char *from, const char *what, const LdpParseError &err);
 
     std::vector<LdpFsm *> getSessions() const;
 
+    const LdpdDispatchStats& getDispatchStats() const;
+
     void handleNewSession(LdpFsm* of);
     void shutdownSession(LdpFsm* of, int32_t code = LDP_SC_SHUTDOWN, uint32_t msgid = 0, uint16_t msgtype = 0);
     void removeSession(LdpFsm* of);
@@ -64,27 +206,64 @@ public:
 
     void tick();
 
-    time_t now() const;
+    uint64_t now() const;
+
+    TimerWheel& getTimerWheel();
+
+    // LdpPduPacker encoders for label mapping / address messages.
+    static ssize_t encodeMapping(void *advertisement, LdpPduWriter &writer);
+    static ssize_t encodeAddresses(void *advertisement, LdpPduWriter &writer);
 
 private:
 
+    static void handleHelloTimer(void *self);
+    static void handleScanTimer(void *self);
+    static void handleHousekeepingTimer(void *self);
+    static void handleAdjacencyTimer(void *adjacency);
+    static void handleConnectTimer(void *connect);
+
+    void updateHelloInterval();
+    void reportDispatchStats();
+
     void installMapping(uint64_t key, LdpLabelMapping &mapping);
+    void uninstallMapping(uint64_t key, const LdpLabelMapping &mapping);
+    void installAlternative(const Prefix &fec);
+
+    void markDirty(const Prefix &fec);
+    void retryUnresolved();
+    void deletePendingMappings();
+    void refreshFec(const Prefix &fec, int lo_ifid);
+    void exportMappings(uint64_t key, LdpFsm *fsm);
 
     void scanInterfaces();
 
     void handleSession();
     void handleSession(int fd);
+    void handleSessionWritable(int fd);
+    void flushSession(int fd);
+    void flushSessions();
     void handleHello();
 
+    bool acceptSession();
+    bool registerSession(int fd, LdpFsm *session);
+    void rejectSession(int fd, LdpFsm *session, int32_t code);
+    void processHello(const uint8_t *buffer, size_t len, const struct sockaddr_in &remote, int ifindex);
+
     void sendHello();
+    int encodeHello();
+    void updateHelloTargets();
     void createSession(uint32_t nei_id, uint16_t nei_ls);
+    void completeConnect(int fd, LdpFsm *session);
+    void abortConnect(int fd, LdpFsm *session);
 
     void createLocalMappings();
+    bool createLocalMapping(const Ipv4Route *route);
     void refreshMappings();
 
-    uint16_t getHoldTime(uint64_t of);
+    uint32_t getHoldTime(uint64_t of);
 
-    uint32_t getNextLabel() const;
+    uint32_t allocateLabel();
+    void releaseLabel(uint32_t label);
 
     bool shouldInstall(const LdpLabelMapping &mapping, uint64_t src = 0);
     bool installed(const LdpLabelMapping &mapping);
@@ -98,6 +277,10 @@ private:
 
     bool _running;
 
+    // all timers (ours, adjacencies, connects, sessions) run on this wheel, in
+    // milliseconds. declared early so it outlives the timers.
+    TimerWheel _timers;
+
     RoutePolicy _import;
     RoutePolicy _export;
 
@@ -110,8 +293,25 @@ private:
     // opened tcp socket fds for sessions
     std::map<int, LdpFsm *> _fds;
 
-    // hello adjacencies - key is (lsrid << 16 + labelspace), value is last hello time.
-    std::map<uint64_t, time_t> _hellos;
+    // session fds with queued output not yet flushed on this wakeup.
+    std::set<int> _tx_pending;
+
+    // session fds waiting for EPOLLOUT - the socket buffer was full.
+    std::set<int> _tx_wait;
+
+    // session fds closed since the last epoll_wait(). the number may already
+    // be reused by a new socket, so what is left of the batch for them is
+    // stale and skipped.
+    std::set<int> _closed;
+
+    // connects in progress - key is fd.
+    std::map<int, LdpConnect> _connects;
+
+    // connect retry state - key is (lsrid << 16 + labelspace).
+    std::map<uint64_t, LdpConnectBackoff> _backoffs;
+
+    // hello adjacencies - key is (lsrid << 16 + labelspace).
+    std::map<uint64_t, LdpAdjacency> _hellos;
 
     // hold timers for neighs
     std::map<uint64_t, uint16_t> _holds;
@@ -123,10 +323,29 @@ private:
     std::map<uint64_t, std::vector<uint32_t>> _addresses;
 
     // mappings of peers.
-    std::map<uint64_t, std::vector<LdpLabelMapping>> _mappings;
-    std::map<uint64_t, std::set<LdpLabelMapping>> _exported_mappings;
-    std::map<uint64_t, std::set<LdpLabelMapping>> _rejected_mappings;
-    std::map<uint64_t, std::set<LdpLabelMapping>> _pending_delete_mappings;
+    MappingDb _mappings;
+
+    // per peer: bindings sent to / rejected by / withdrawn by the peer,
+    // identified by fec and direction.
+    std::map<uint64_t, LdpLabelMappingSet> _exported_mappings;
+    std::map<uint64_t, LdpLabelMappingSet> _rejected_mappings;
+    std::map<uint64_t, LdpLabelMappingSet> _pending_delete_mappings;
+
+    // fecs to look at on the next refresh: a binding for them was added or
+    // changed, a route to them changed, or the binding in use went away.
+    FecQueue _dirty;
+
+    // fecs that could not be installed for now (no address or route to the
+    // peer, out of labels). they are looked at again once that may have
+    // changed.
+    std::unordered_set<Prefix, PrefixHash> _unresolved;
+
+    // per session: fecs whose bindings are to be (re-)checked for sending
+    // to the peer. a new session gets every fec queued.
+    std::map<uint64_t, FecQueue> _export_queues;
+
+    // in labels: of local mappings, and of remote mappings once installed.
+    LabelAllocator _labels;
 
     // interface cache
     std::vector<Interface> _ifaces;
@@ -134,20 +353,31 @@ private:
     // where to load routes to assign labels
     std::set<RoutingProtocol> _srcs;
 
-    // timers
-    uint16_t _hello;
+    // timers - ms, except _keep, which is in seconds.
+    uint32_t _hello;
     uint16_t _keep;
-    uint16_t _hold;
-    uint16_t _ifscan;
+    uint32_t _hold;
+    uint32_t _ifscan;
+
+    // max pdu length proposed to neighbors.
+    uint16_t _max_pdu;
 
     // time last hello is sent out
-    time_t _last_hello;
+    uint64_t _last_hello;
+
+    // time between hellos: our hello interval, or less if a peer's hold time
+    // needs it.
+    uint32_t _hello_interval;
 
-    // time last interfaces scan
-    time_t _last_scan;
+    Timer _hello_timer;
+    Timer _scan_timer;
+    Timer _housekeeping_timer;
 
-    // time now.
-    time_t _now;
+    // time now, ms on the monotonic clock.
+    uint64_t _now;
+
+    // wakes the event loop up when the next timer is due.
+    Clock _clock;
 
     // fd for the master tcp socket (the one use w/ accept syscall)
     int _tfd;
@@ -155,6 +385,39 @@ private:
     // fd for the mcast udp listening socket
     int _ufd;
 
+    // hello receive buffers.
+    LdpHelloBatch *_hello_batch;
+
+    // parse errors are triggered by whatever the neighbors (or anyone on the
+    // link, for hellos) send - their logging is rate limited.
+    LogLimiter _parse_log;
+
+    // received hellos are parsed into this arena, and it is reset once the
+    // hello is done with.
+    Arena _pdu_arena;
+
+    // encoded hello pdu, re-encoded only when _hello_dirty is set (hold time,
+    // transport address, or config sequence changed).
+    uint8_t *_hello_pdu;
+    size_t _hello_len;
+    bool _hello_dirty;
+
+    // configuration sequence number sent in hellos.
+    uint32_t _config_seq;
+
+    // where hellos go out: outgoing interface and source address of each
+    // ldp interface. updated on interface scan.
+    std::vector<struct in_pktinfo> _hello_targets;
+
+    // event loop - _tfd, _ufd, the router fd and session fds are registered
+    // here once and dispatched by readiness.
+    Epoll _ev;
+
+    LdpdDispatchStats _stats;
+
+    // _stats as of the last time they were logged.
+    LdpdDispatchStats _stats_reported;
+
     // metric to use for routes.
     int _metric;
 
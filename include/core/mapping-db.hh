@@ -0,0 +1,68 @@
+#ifndef LDP_MAPPING_DB_H
+#define LDP_MAPPING_DB_H
+#include "core/label-mapping.hh"
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+#include <vector>
+#include <unordered_map>
+
+namespace ldpd {
+
+struct PrefixHash {
+    size_t operator()(const Prefix &prefix) const;
+};
+
+/**
+ * @brief label information base: the label bindings we know of, keyed by
+ * (peer, fec).
+ *
+ * each peer (the local router included, under its own key) has at most one
+ * binding per fec, so a repeated mapping updates the binding in place, and
+ * a withdraw finds it directly. a second index keeps, per fec, the peers
+ * w/ a binding for it, and which one of them is in use (installed), so
+ * picking another one when it goes away does not need a scan either.
+ *
+ * bindings are not moved once added - pointers to them are valid until they
+ * are removed.
+ */
+class MappingDb {
+public:
+    typedef std::unordered_map<Prefix, LdpLabelMapping, PrefixHash> Bindings;
+
+    MappingDb();
+
+    LdpLabelMapping* update(uint64_t peer, const LdpLabelMapping &mapping);
+    LdpLabelMapping* find(uint64_t peer, const Prefix &fec);
+    const LdpLabelMapping* find(uint64_t peer, const Prefix &fec) const;
+    int remove(uint64_t peer, const Prefix &fec);
+
+    bool hasPeer(uint64_t peer) const;
+    Bindings* getBindings(uint64_t peer);
+
+    std::map<uint64_t, Bindings>& getPeers();
+    const std::vector<uint64_t>* getPeers(const Prefix &fec) const;
+
+    uint64_t getActive(const Prefix &fec) const;
+    void setActive(const Prefix &fec, uint64_t peer);
+
+    size_t size() const;
+
+private:
+    struct FecEntry {
+        // peers w/ a binding for the fec.
+        std::vector<uint64_t> peers;
+
+        // peer whose binding is in use, 0 if none.
+        uint64_t active;
+    };
+
+    std::map<uint64_t, Bindings> _peers;
+    std::unordered_map<Prefix, FecEntry, PrefixHash> _fecs;
+
+    size_t _size;
+};
+
+}
+
+#endif // LDP_MAPPING_DB_H
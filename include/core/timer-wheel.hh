@@ -0,0 +1,97 @@
+#ifndef LDP_TIMER_WHEEL_H
+#define LDP_TIMER_WHEEL_H
+#include <stdint.h>
+
+// 6 levels of 64 slots: level n slot covers 64^n ticks, the wheel covers
+// 2^36 ticks. timers further out than that wait in the top level and get
+// re-sorted each time the top level wraps around.
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 6
+
+#define TIMER_WHEEL_NEVER UINT64_MAX
+
+namespace ldpd {
+
+class TimerWheel;
+
+typedef void (*ldp_timer_handler_t)(void *data);
+
+/**
+ * @brief a timer. embed it in the object that owns the timeout, set the
+ * handler with setHandler() and arm it with TimerWheel::schedule().
+ *
+ * the handler is called w/ the timer already disarmed, so it can re-arm the
+ * timer or delete its owner. an armed timer is canceled when destroyed.
+ *
+ * a copy is a new timer: unarmed and w/o handler, as the handler data of
+ * the original belongs to the original's owner.
+ */
+class Timer {
+public:
+    Timer();
+    Timer(const Timer &);
+    ~Timer();
+
+    void setHandler(ldp_timer_handler_t handler, void *data);
+
+    bool armed() const;
+    uint64_t getExpiry() const;
+
+private:
+    Timer& operator=(const Timer &);
+
+    friend class TimerWheel;
+
+    Timer *_prev;
+    Timer *_next;
+
+    uint64_t _expires;
+
+    ldp_timer_handler_t _handler;
+    void *_data;
+
+    // wheel we are on, nullptr if not armed.
+    TimerWheel *_wheel;
+    uint8_t _level;
+    uint8_t _slot;
+};
+
+/**
+ * @brief hierarchical timer wheel. arm and cancel are O(1); advancing time
+ * jumps straight to the next occupied slot with the help of per-level
+ * occupancy bitmaps, so time spent is proportional to the timers that fire,
+ * not to the time passed or the timers armed.
+ *
+ * time is in ticks, the unit is up to the user.
+ */
+class TimerWheel {
+public:
+    TimerWheel(uint64_t now = 0);
+    ~TimerWheel();
+
+    void schedule(Timer *timer, uint64_t expires);
+    void cancel(Timer *timer);
+
+    void advance(uint64_t now);
+
+    uint64_t nextEvent() const;
+    uint64_t now() const;
+
+private:
+    void place(Timer *timer);
+    void link(Timer *timer, int level, int slot);
+    void unlink(Timer *timer);
+
+    void cascade(uint64_t prev);
+    void expire();
+
+    Timer *_slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    uint64_t _occupied[TIMER_WHEEL_LEVELS];
+
+    uint64_t _now;
+};
+
+}
+
+#endif // LDP_TIMER_WHEEL_H
@@ -5,11 +5,19 @@
 #include <string>
 #include "core/ldpd.hh"
 #include "ldp-pdu/ldp-pdu.hh"
+#include "ldp-message/ldp-message-view.hh"
+#include "ldp-pdu/ldp-pdu-reassembler.hh"
+#include "ldp-pdu/ldp-pdu-queue.hh"
+#include "ldp-pdu/ldp-pdu-writer.hh"
+
+// a pdu w/ nothing but a keepalive in it: pdu header, ldp id, and a
+// keepalive message w/o tlvs.
+#define LDP_KEEPALIVE_PDU_LEN (LDP_PDU_MIN_LEN + LDP_MSG_MIN_LEN)
 
 namespace ldpd {
     
 enum LdpSessionState {
-    Invalid = 0, Initialized, OpenReceived, OpenSent, Operational
+    Invalid = 0, Connecting, Initialized, OpenReceived, OpenSent, Operational
 };
 
 class LdpFsm {
@@ -18,6 +26,7 @@ public:
 
     ssize_t receive(const uint8_t *packet, size_t size);
 
+    void connecting(uint32_t neighId, uint16_t neighLabelSpace);
     ssize_t init(uint32_t neighId, uint16_t neighLabelSpace);
 
     LdpSessionState getState() const;
@@ -28,27 +37,61 @@ public:
     uint32_t getNeighborId() const;
     uint16_t getNeighborLabelSpace() const;
 
-    ssize_t send(LdpPdu &pdu);
+    uint16_t getMaxPduLength() const;
+
+    int getFd() const;
+    void setFd(int fd);
+
+    LdpPduReassembler& getReceiveBuffer();
+    LdpPduQueue& getSendQueue();
+
+    ssize_t beginPdu(LdpPduWriter &writer, size_t size = 0);
+    ssize_t send(LdpPduWriter &writer);
+
     ssize_t sendKeepalive();
     ssize_t sendNotification(uint32_t msgid, uint16_t msgtype, uint32_t code);
 
-    void tick();
-
 private:
-    int processInit(const LdpMessage *init);
+    static void handleKeepaliveTimer(void *self);
+    static void handleHoldTimer(void *self);
+
+    static bool isKeepalivePdu(const uint8_t *packet, size_t size);
+
+    uint32_t getKeepaliveInterval() const;
 
-    void fillPduHeader(LdpPdu &to) const;
-    void createInitPdu(LdpPdu &to);
+    int processInit(const LdpMessageView &init);
+
+    ssize_t sendInit();
 
     void changeState(LdpSessionState newState);
 
+    // negotiated keepalive time, in seconds.
     uint16_t _keep;
-    time_t _last_send, _last_recv;
+
+    // negotiated max pdu length: the smaller of ours and the neighbor's.
+    uint16_t _max_pdu;
+
+    // ms on the monotonic clock.
+    uint64_t _last_send, _last_recv;
+
+    // started once operational. they are only moved forward when they fire,
+    // not on every pdu sent/received.
+    Timer _keepalive_timer;
+    Timer _hold_timer;
 
     uint32_t _neighId;
     uint16_t _neighLs;
     LdpSessionState _state;
     Ldpd *_ldpd;
+
+    // session socket.
+    int _fd;
+
+    // bytes read from the session socket, not yet handed to receive().
+    LdpPduReassembler _rx;
+
+    // encoded pdus not yet written to the session socket.
+    LdpPduQueue _tx;
 };
 
 }
@@ -0,0 +1,49 @@
+#ifndef LDP_PDU_PACKER_H
+#define LDP_PDU_PACKER_H
+#include "ldp-pdu/ldp-pdu-writer.hh"
+
+#include <stdint.h>
+#include <unistd.h>
+
+namespace ldpd {
+
+class LdpFsm;
+
+// writes a single message to the writer. returns the size of the message, or
+// -1 if it did not fit.
+typedef ssize_t (*LdpMessageEncoder)(void *data, LdpPduWriter &writer);
+
+/**
+ * @brief pack messages for a session into as few pdus as possible.
+ *
+ * messages are added to the open pdu until one does not fit the negotiated
+ * max pdu length; that pdu is then queued and the message goes into a new
+ * one. call flush() to queue the last pdu.
+ */
+class LdpPduPacker {
+public:
+    LdpPduPacker(LdpFsm *session);
+    ~LdpPduPacker();
+
+    ssize_t add(LdpMessageEncoder encoder, void *data);
+    ssize_t flush();
+
+    size_t length() const;
+    size_t pdus() const;
+    size_t messages() const;
+
+private:
+    LdpFsm *_session;
+    LdpPduWriter _writer;
+
+    // a pdu is started in the send queue of the session.
+    bool _open;
+
+    // pdus queued / messages added so far.
+    size_t _pdus;
+    size_t _messages;
+};
+
+}
+
+#endif // LDP_PDU_PACKER_H
@@ -0,0 +1,70 @@
+#ifndef LDP_MESSAGE_VIEW_H
+#define LDP_MESSAGE_VIEW_H
+#include "ldp-tlv/ldp-tlv-view.hh"
+#include "ldp-pdu/ldp-parse-error.hh"
+
+#include <stdint.h>
+#include <unistd.h>
+
+// type + length field.
+#define LDP_MSG_HDR_LEN 4
+
+// header + message id.
+#define LDP_MSG_MIN_LEN 8
+
+namespace ldpd {
+
+/**
+ * @brief read-only view of a message in a receive buffer.
+ *
+ * parse() checks the message header and the length of every tlv in it, so
+ * the tlvs can be walked afterwards w/o further checks. nothing is copied or
+ * allocated; the view is valid for as long as the buffer is.
+ */
+class LdpMessageView {
+public:
+    LdpMessageView();
+    LdpMessageView(const uint8_t *msg, size_t len);
+
+    ssize_t parse(const uint8_t *from, size_t buf_sz, LdpParseError *err = nullptr);
+
+    bool unknown() const;
+
+    uint16_t getType() const;
+    uint16_t getLength() const;
+    uint32_t getId() const;
+
+    const uint8_t* data() const;
+    size_t size() const;
+
+    LdpTlvIterator begin() const;
+    LdpTlvIterator end() const;
+
+    LdpTlvView getTlv(uint16_t type) const;
+
+private:
+    const uint8_t *_msg;
+    size_t _len;
+};
+
+/**
+ * @brief iterate over the messages in a buffer that was already checked to be
+ * a valid sequence of messages (see LdpPduView::parse).
+ */
+class LdpMessageIterator {
+public:
+    LdpMessageIterator(const uint8_t *at, const uint8_t *end);
+
+    LdpMessageView operator*() const;
+    LdpMessageIterator& operator++();
+
+    bool operator!=(const LdpMessageIterator &other) const;
+
+private:
+    const uint8_t *_at;
+    const uint8_t *_end;
+};
+
+}
+
+#endif // LDP_MESSAGE_VIEW_H
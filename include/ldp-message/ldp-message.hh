@@ -2,7 +2,9 @@
 #define LDP_MESSAGE_H
 
 #include <vector>
+#include "core/arena.hh"
 #include "ldp-tlv/ldp-raw-tlv.hh"
+#include "ldp-message/ldp-message-view.hh"
 
 #define LDP_MSGTYPE_NOTIFICATION 0x0001
 #define LDP_MSGTYPE_HELLO 0x0100
@@ -18,9 +20,14 @@
 
 namespace ldpd {
 
-class LdpMessage : public Serializable {
+struct LdpTlvIndexEntry {
+    uint16_t type;
+    LdpRawTlv *tlv;
+};
+
+class LdpMessage : public Serializable, public ArenaObject {
 public:
-    LdpMessage();
+    LdpMessage(Arena *arena = nullptr);
     ~LdpMessage();
 
     bool unknown() const;
@@ -42,18 +49,44 @@ public:
     const std::vector<LdpRawTlv *> getTlvs() const;
     const LdpRawTlv* getTlv(uint16_t type) const;
 
+    /**
+     * @brief get the parsed value of the first tlv of the value's type. the
+     * value is parsed on first use and cached in the tlv.
+     * 
+     * @tparam T value type (LdpFecTlvValue, LdpStatusTlvValue, etc.)
+     * @return const T* value, owned by the message - valid until the tlv
+     * changes or the message is freed. nullptr if there is no such tlv or it
+     * can't be parsed.
+     */
+    template <typename T> const T* getValue() const {
+        const LdpRawTlv *tlv = getTlv(T::TYPE);
+
+        return tlv == nullptr ? nullptr : tlv->getValue<T>();
+    }
+
 protected:
+    void buildIndex() const;
+
     uint16_t _type;
     uint16_t _length;
     uint32_t _id;
     bool _unknown;
 
-    std::vector<LdpRawTlv *> _tlvs;
+    // where tlvs parsed into this message are allocated, nullptr for heap.
+    Arena *_arena;
+
+    std::vector<LdpRawTlv *, ArenaAllocator<LdpRawTlv *>> _tlvs;
+
+    // first tlv of each type, sorted by type. built at parse time, or on the
+    // first lookup after tlvs were added.
+    mutable std::vector<LdpTlvIndexEntry, ArenaAllocator<LdpTlvIndexEntry>> _index;
+    mutable bool _indexed;
 
 // ----------------------------------------------------------------------------
 
 public:
     ssize_t parse(const uint8_t *from, size_t buf_sz);
+    ssize_t parse(const LdpMessageView &msg);
     ssize_t write(uint8_t *to, size_t buf_sz) const;
     size_t length() const;
 };
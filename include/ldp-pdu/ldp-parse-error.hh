@@ -0,0 +1,55 @@
+#ifndef LDP_PARSE_ERROR_H
+#define LDP_PARSE_ERROR_H
+#include <stdint.h>
+#include <unistd.h>
+
+// set err (if not nullptr) and return -1 from the calling parser.
+#define LDP_PARSE_FAIL(err, code, offset) do {\
+    if ((err) != nullptr) {\
+        (err)->set((code), (offset));\
+    }\
+    return -1;\
+} while (0)
+
+namespace ldpd {
+
+/**
+ * @brief why a pdu could not be parsed.
+ */
+enum LdpParseErrorCode {
+    ParseOk = 0,
+    ParseBadVersion,
+    ParseBadPduLength,
+    ParseBadMessageLength,
+    ParseBadTlvLength,
+    ParseUnknownTlv,
+    ParseUnknownFec,
+    ParseUnsupportedAf,
+    ParseMalformedValue
+};
+
+/**
+ * @brief parse error: what went wrong and where.
+ *
+ * the parsers only fill this in and return -1; they don't log. the caller
+ * decides what to log (and how often) and which notification to send, see
+ * ldpParseErrorStatus().
+ */
+struct LdpParseError {
+    LdpParseError();
+
+    void set(LdpParseErrorCode code, size_t offset);
+
+    LdpParseErrorCode code;
+
+    // offset of the bad field, from the start of what was given to the
+    // outermost parse().
+    size_t offset;
+};
+
+uint32_t ldpParseErrorStatus(LdpParseErrorCode code);
+const char* ldpParseErrorText(LdpParseErrorCode code);
+
+}
+
+#endif // LDP_PARSE_ERROR_H
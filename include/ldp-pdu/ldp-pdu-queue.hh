@@ -0,0 +1,67 @@
+#ifndef LDP_PDU_QUEUE_H
+#define LDP_PDU_QUEUE_H
+#include <stdint.h>
+#include <unistd.h>
+#include <deque>
+
+#define LDP_TXQ_CHUNK_SIZE 16384
+
+// max iovecs handed to a single writev().
+#define LDP_TXQ_IOV_MAX 64
+
+// a queue holding more than the high watermark is congested until it drains
+// below the low watermark.
+#define LDP_TXQ_HIGH_WATERMARK (256 * 1024)
+#define LDP_TXQ_LOW_WATERMARK (64 * 1024)
+
+namespace ldpd {
+
+struct LdpPduQueueChunk {
+    uint8_t *data;
+    size_t size;
+
+    // queued data is data[head, tail).
+    size_t head;
+    size_t tail;
+};
+
+/**
+ * @brief output queue of encoded pdus for a session.
+ *
+ * pdus are appended with push() (or reserve()/commit() to encode in place)
+ * and written out with flush(), which writes as much as the socket takes
+ * with writev() and keeps the rest, including partially written pdus, for
+ * the next flush.
+ */
+class LdpPduQueue {
+public:
+    LdpPduQueue();
+    ~LdpPduQueue();
+
+    ssize_t push(const uint8_t *buffer, size_t len);
+
+    uint8_t* reserve(size_t len);
+    void commit(size_t len);
+
+    ssize_t flush(int fd);
+
+    size_t pending() const;
+    bool congested() const;
+
+    void clear();
+
+private:
+    void updateCongestion();
+
+    std::deque<LdpPduQueueChunk> _chunks;
+
+    // a drained chunk kept around so steady traffic doesn't malloc.
+    LdpPduQueueChunk _spare;
+
+    size_t _pending;
+    bool _congested;
+};
+
+}
+
+#endif // LDP_PDU_QUEUE_H
@@ -0,0 +1,66 @@
+#ifndef LDP_PDU_REASSEMBLER_H
+#define LDP_PDU_REASSEMBLER_H
+#include <stdint.h>
+#include <unistd.h>
+
+// version + length field.
+#define LDP_PDU_HDR_LEN 4
+
+// smallest pdu: header plus lsr-id and label space.
+#define LDP_PDU_MIN_LEN 10
+
+// largest pdu the 16-bit length field can describe.
+#define LDP_PDU_MAX_LEN (0xffff + LDP_PDU_HDR_LEN)
+
+#define LDP_REASM_INIT_SIZE 16384
+#define LDP_REASM_MAX_SIZE (2 * LDP_PDU_MAX_LEN)
+#define LDP_REASM_MIN_READ 4096
+
+#define LDP_REASM_PDU 1
+#define LDP_REASM_NEED_MORE 0
+#define LDP_REASM_BAD_LENGTH -1
+
+namespace ldpd {
+
+/**
+ * @brief stream reassembly buffer for ldp over tcp.
+ *
+ * bytes read from the socket go in through prepare()/commit(), and complete
+ * pdus, framed by the length field in the pdu header, come out of next().
+ * partial pdus are kept until the rest arrives. the buffer grows (up to
+ * LDP_REASM_MAX_SIZE) when a read fills it up or when a pdu does not fit, so
+ * large bursts can be read in big chunks.
+ */
+class LdpPduReassembler {
+public:
+    LdpPduReassembler();
+    ~LdpPduReassembler();
+
+    uint8_t* prepare(size_t &avail);
+    void commit(size_t len);
+
+    int next(const uint8_t* &pdu, size_t &len);
+
+    size_t pending() const;
+    size_t capacity() const;
+
+    void clear();
+
+private:
+    void compact();
+    bool grow(size_t size);
+
+    uint8_t *_buffer;
+    size_t _size;
+
+    // unread data is _buffer[_head, _tail).
+    size_t _head;
+    size_t _tail;
+
+    // size we want the buffer to be before the next read.
+    size_t _want;
+};
+
+}
+
+#endif // LDP_PDU_REASSEMBLER_H
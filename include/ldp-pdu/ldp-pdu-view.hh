@@ -0,0 +1,46 @@
+#ifndef LDP_PDU_VIEW_H
+#define LDP_PDU_VIEW_H
+#include "ldp-pdu/ldp-pdu.hh"
+#include "ldp-pdu/ldp-pdu-reassembler.hh"
+#include "ldp-message/ldp-message-view.hh"
+#include "ldp-pdu/ldp-parse-error.hh"
+
+#include <stdint.h>
+#include <unistd.h>
+
+namespace ldpd {
+
+/**
+ * @brief read-only view of a pdu in a receive buffer.
+ *
+ * parse() checks the pdu header, and the length of every message and tlv in
+ * the pdu in a single pass. after that the messages can be walked w/o further
+ * checks - or built into an LdpPdu (LdpPdu::parse(const LdpPduView &)) w/o
+ * checking them again. nothing is copied or allocated; the view (and the message and tlv
+ * views from it) are valid for as long as the buffer is.
+ */
+class LdpPduView {
+public:
+    LdpPduView();
+
+    ssize_t parse(const uint8_t *from, size_t buf_sz, LdpParseError *err = nullptr);
+
+    uint16_t getVersion() const;
+    uint16_t getLength() const;
+    uint32_t getRouterId() const;
+    uint16_t getLabelSpace() const;
+
+    const uint8_t* data() const;
+    size_t size() const;
+
+    LdpMessageIterator begin() const;
+    LdpMessageIterator end() const;
+
+private:
+    const uint8_t *_pdu;
+    size_t _len;
+};
+
+}
+
+#endif // LDP_PDU_VIEW_H
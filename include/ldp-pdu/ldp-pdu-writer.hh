@@ -0,0 +1,73 @@
+#ifndef LDP_PDU_WRITER_H
+#define LDP_PDU_WRITER_H
+#include "ldp-tlv/ldp-tlv-value.hh"
+
+#include <stdint.h>
+#include <unistd.h>
+
+namespace ldpd {
+
+/**
+ * @brief encode a pdu straight into a buffer.
+ *
+ * messages and tlvs are appended in order: begin(), then beginMessage(),
+ * tlvs, endMessage() for each message, then end(). length fields are
+ * written as placeholders and patched once the message / tlv / pdu is
+ * complete, so nothing is built up front and nothing is allocated.
+ *
+ * once something does not fit, every following call fails until the open
+ * message is dropped with rollbackMessage(); the pdu up to the last complete
+ * message can still be finished with end().
+ */
+class LdpPduWriter {
+public:
+    LdpPduWriter();
+    LdpPduWriter(uint8_t *buffer, size_t size);
+
+    void reset(uint8_t *buffer, size_t size);
+
+    ssize_t begin(uint32_t routerId, uint16_t labelSpace);
+    ssize_t end();
+
+    ssize_t beginMessage(uint16_t type, uint32_t id);
+    ssize_t endMessage();
+    void rollbackMessage();
+
+    ssize_t beginTlv(uint16_t type);
+    ssize_t endTlv();
+
+    ssize_t addTlv(const LdpTlvValue &value);
+    ssize_t addRawTlv(const uint8_t *tlv, size_t len);
+
+    ssize_t putU8(uint8_t value);
+    ssize_t putU16(uint16_t value);
+    ssize_t putU32(uint32_t value);
+    ssize_t put(const void *data, size_t len);
+
+    const uint8_t* data() const;
+    size_t length() const;
+    size_t remaining() const;
+    size_t messages() const;
+
+    bool failed() const;
+
+private:
+    void patchLength(size_t at, size_t len);
+
+    uint8_t *_buffer;
+    size_t _size;
+    size_t _pos;
+
+    // offsets of the open message and tlv. 0 if none is open (nothing can
+    // start at 0 but the pdu).
+    size_t _msg;
+    size_t _tlv;
+
+    size_t _messages;
+
+    bool _failed;
+};
+
+}
+
+#endif // LDP_PDU_WRITER_H
@@ -3,15 +3,23 @@
 #include <vector>
 
 #include "core/serializable.hh"
+#include "core/arena.hh"
 #include "ldp-message/ldp-message.hh"
 
 #define LDP_VERSION 1
 
+// default max pdu length (rfc5036 3.5.3). a max pdu length of
+// LDP_MAX_PDU_LEN_USE_DEF or less in the session params means this.
+#define LDP_DEF_MAX_PDU_LEN 4096
+#define LDP_MAX_PDU_LEN_USE_DEF 255
+
 namespace ldpd {
 
-class LdpPdu : public Serializable {
+class LdpPduView;
+
+class LdpPdu : public Serializable, public ArenaObject {
 public:
-    LdpPdu();
+    LdpPdu(Arena *arena = nullptr);
     ~LdpPdu();
 
     uint16_t getVersion() const;
@@ -40,12 +48,17 @@ private:
     uint16_t _length;
     uint32_t _routerId;
     uint16_t _labelSpace;
-    std::vector<LdpMessage *> _messages;
+
+    // where messages parsed into this pdu are allocated, nullptr for heap.
+    Arena *_arena;
+
+    std::vector<LdpMessage *, ArenaAllocator<LdpMessage *>> _messages;
 
 // ----------------------------------------------------------------------------
 
 public:
     ssize_t parse(const uint8_t *from, size_t msg_sz);
+    ssize_t parse(const LdpPduView &pdu);
     ssize_t write(uint8_t *to, size_t buf_sz) const;
     size_t length() const;
 };
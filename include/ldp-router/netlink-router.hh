@@ -2,6 +2,7 @@
 #define LDP_NETLINK_ROUTER_H
 #include "sysdep/linux/netlink.hh"
 #include "abstraction/router.hh"
+#include <unordered_map>
 
 namespace ldpd {
 
@@ -15,11 +16,16 @@ public:
     std::vector<const Route *> getRoutes();
     std::vector<const Route *> getFib();
 
+    const Ipv4Route* findIpv4Route(const Prefix &prefix);
+    const MplsRoute* findMplsRoute(uint32_t label);
+
     uint64_t addRoute(Route *route);
     bool deleteRoute(const Route *selector);
 
     void onRouteChange(void* data, ldp_routechange_handler_t handler);
 
+    int getFd() const;
+
     void tick();
 
 private:
@@ -59,11 +65,14 @@ private:
     }
 
     Netlink _nl;
-    std::multimap<uint64_t, Route *> _rib;
+
+    // routes keyed by Route::hash(), so lookups by prefix / in label
+    // (findIpv4Route(), findMplsRoute()) take constant time.
+    std::unordered_multimap<uint64_t, Route *> _rib;
 
     std::vector<Route *> _rib_pending_del;
 
-    std::multimap<uint64_t, Route *> _fib;
+    std::unordered_multimap<uint64_t, Route *> _fib;
 
     ldp_routechange_handler_t _onroutechange;
     void *_routechange_data;
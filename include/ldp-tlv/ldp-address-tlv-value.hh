@@ -2,6 +2,7 @@
 #define LDP_ADDRESS_TLV_H
 #include "core/serializable.hh"
 #include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
 #include "ldp-fec-element.hh"
 
 #include <vector>
@@ -14,11 +15,14 @@ public:
     ~LdpAddressTlvValue();
     uint16_t getType() const;
 
+    static const uint16_t TYPE = LDP_TLVTYPE_ADDRESS_LIST;
+
     const std::vector<uint32_t> getAddresses() const;
 
     void clearAddresses();
 
     ssize_t addAddress(uint32_t address);
+    ssize_t addAddresses(const uint32_t *addresses, size_t count);
 
 private:
     std::vector<uint32_t> _addresses;
@@ -2,6 +2,7 @@
 #define LDP_COMMON_HELLO_PARAMS_TLV_H
 #include "core/serializable.hh"
 #include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
 #include "ldp-fec-element.hh"
 
 namespace ldpd {
@@ -12,6 +13,8 @@ public:
     ~LdpCommonHelloParamsTlvValue();
     uint16_t getType() const;
 
+    static const uint16_t TYPE = LDP_TLVTYPE_COMMON_HELLO;
+
     uint16_t getHoldTime() const;
     bool targeted() const;
     bool requestTargeted() const;
@@ -2,6 +2,7 @@
 #define LDP_COMMON_SESSION_PARAMS_TLV_H
 #include "core/serializable.hh"
 #include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
 
 namespace ldpd {
 
@@ -11,6 +12,8 @@ public:
     ~LdpCommonSessionParamsTlvValue();
     uint16_t getType() const;
 
+    static const uint16_t TYPE = LDP_TLVTYPE_COMMON_SESSION;
+
     uint16_t getProtocolVersion() const;
     uint16_t getKeepaliveTime() const;
     uint16_t getPathVectorLimit() const;
@@ -2,6 +2,7 @@
 #define LDP_CONFIG_SEQ_NUM_TLV_H
 #include "core/serializable.hh"
 #include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
 
 namespace ldpd {
 
@@ -11,6 +12,8 @@ public:
     ~LdpConfigSeqNumTlvValue();
     uint16_t getType() const;
 
+    static const uint16_t TYPE = LDP_TLVTYPE_CONFIGURATION_SEQ;
+
     uint32_t getSeq() const;
 
     ssize_t setSeq(uint32_t seq);
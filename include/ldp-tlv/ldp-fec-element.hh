@@ -1,10 +1,11 @@
 #ifndef LDP_FEC_ELEMENT_H
 #define LDP_FEC_ELEMENT_H
 #include "core/serializable.hh"
+#include "core/arena.hh"
 
 namespace ldpd {
 
-class LdpFecElement : public Serializable {
+class LdpFecElement : public Serializable, public ArenaObject {
 public:
     virtual ~LdpFecElement() {};
     virtual uint8_t getType() const = 0;
@@ -1,6 +1,7 @@
 #ifndef LDP_FEC_PREFIX_ELEMENT_H
 #define LDP_FEC_PREFIX_ELEMENT_H
 #include "core/serializable.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
 #include "ldp-tlv/ldp-fec-element.hh"
 
 namespace ldpd {
@@ -10,6 +11,8 @@ public:
     LdpFecPrefixElement();
     uint8_t getType() const;
 
+    static const uint8_t TYPE = LDP_FEC_PREFIX;
+
     uint32_t getPrefix() const;
     uint8_t getPrefixLength() const;
 
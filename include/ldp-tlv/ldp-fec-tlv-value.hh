@@ -2,6 +2,8 @@
 #define LDP_FEC_TLV_H
 #include "core/serializable.hh"
 #include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
+#include "core/arena.hh"
 #include "ldp-fec-element.hh"
 
 #include <vector>
@@ -10,10 +12,12 @@ namespace ldpd {
 
 class LdpFecTlvValue : public LdpTlvValue {
 public:
-    LdpFecTlvValue();
+    LdpFecTlvValue(Arena *arena = nullptr);
     ~LdpFecTlvValue();
     uint16_t getType() const;
 
+    static const uint16_t TYPE = LDP_TLVTYPE_FEC;
+
     const std::vector<LdpFecElement *> getElements() const;
 
     void clearElements();
@@ -21,7 +25,10 @@ public:
     ssize_t addElement(LdpFecElement *element);
 
 private:
-    std::vector<LdpFecElement *> _elements;
+    // where elements parsed into this value are allocated, nullptr for heap.
+    Arena *_arena;
+
+    std::vector<LdpFecElement *, ArenaAllocator<LdpFecElement *>> _elements;
 
 // ----------------------------------------------------------------------------
 
@@ -0,0 +1,42 @@
+#ifndef LDP_FEC_TYPED_WILDCARD_ELEMENT_H
+#define LDP_FEC_TYPED_WILDCARD_ELEMENT_H
+#include "core/serializable.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
+#include "ldp-tlv/ldp-fec-element.hh"
+
+namespace ldpd {
+
+/**
+ * @brief typed wildcard fec element (rfc5918): all fecs of the given fec
+ * element type (and address family, for prefix fecs).
+ */
+class LdpFecTypedWildcardElement : public LdpFecElement {
+public:
+    LdpFecTypedWildcardElement();
+    uint8_t getType() const;
+
+    static const uint8_t TYPE = LDP_FEC_TYPED_WILDCARD;
+
+    uint8_t getFecType() const;
+    uint16_t getAddressFamily() const;
+
+    ssize_t setFecType(uint8_t type);
+    ssize_t setAddressFamily(uint16_t af);
+
+private:
+    uint8_t _fec_type;
+
+    // only for prefix fecs, 0 otherwise.
+    uint16_t _af;
+
+// ----------------------------------------------------------------------------
+
+public:
+    ssize_t parse(const uint8_t *from, size_t buf_sz);
+    ssize_t write(uint8_t *to, size_t buf_sz) const;
+    size_t length() const;
+};
+
+}
+
+#endif // LDP_FEC_TYPED_WILDCARD_ELEMENT_H
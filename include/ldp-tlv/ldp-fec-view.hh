@@ -0,0 +1,34 @@
+#ifndef LDP_FEC_VIEW_H
+#define LDP_FEC_VIEW_H
+#include "ldp-tlv/ldp-tlv-view.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
+#include "ldp-pdu/ldp-parse-error.hh"
+
+#include <stdint.h>
+#include <unistd.h>
+
+namespace ldpd {
+
+/**
+ * @brief walk the elements of a fec tlv in a receive buffer, one at a time,
+ * without allocating an element object for each of them (what
+ * LdpFecTlvValue::parse does).
+ */
+class LdpFecView {
+public:
+    LdpFecView(const LdpTlvView &fec);
+
+    int next(uint8_t &type, uint32_t &prefix, uint8_t &prefixLength, LdpParseError *err = nullptr);
+
+    void rewind();
+
+private:
+    const uint8_t *_value;
+    size_t _len;
+
+    size_t _offset;
+};
+
+}
+
+#endif // LDP_FEC_VIEW_H
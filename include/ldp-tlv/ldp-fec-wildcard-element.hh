@@ -1,6 +1,7 @@
 #ifndef LDP_FEC_WILDCARD_ELEMENT_H
 #define LDP_FEC_WILDCARD_ELEMENT_H
 #include "core/serializable.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
 #include "ldp-tlv/ldp-fec-element.hh"
 
 namespace ldpd {
@@ -8,6 +9,8 @@ namespace ldpd {
 class LdpFecWildcardElement : public LdpFecElement {
 public:
     uint8_t getType() const;
+
+    static const uint8_t TYPE = LDP_FEC_WILDCARD;
     
 // ----------------------------------------------------------------------------
 
@@ -2,6 +2,7 @@
 #define LDP_GENERIC_LABEL_TLV_H
 #include "core/serializable.hh"
 #include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
 
 namespace ldpd {
 
@@ -10,6 +11,8 @@ public:
     LdpGenericLabelTlvValue();
 
     uint16_t getType() const;
+
+    static const uint16_t TYPE = LDP_TLVTYPE_GENERIC_LABEL;
     uint32_t getLabel() const;
     
     ssize_t setLabel(uint32_t label);
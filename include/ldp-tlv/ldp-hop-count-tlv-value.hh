@@ -0,0 +1,34 @@
+#ifndef LDP_HOP_COUNT_TLV_H
+#define LDP_HOP_COUNT_TLV_H
+#include "core/serializable.hh"
+#include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
+
+namespace ldpd {
+
+class LdpHopCountTlvValue : public LdpTlvValue {
+public:
+    LdpHopCountTlvValue();
+
+    uint16_t getType() const;
+
+    static const uint16_t TYPE = LDP_TLVTYPE_HOP_COUNT;
+
+    uint8_t getCount() const;
+
+    ssize_t setCount(uint8_t count);
+
+private:
+    uint8_t _count;
+
+// ----------------------------------------------------------------------------
+
+public:
+    ssize_t parse(const uint8_t *from, size_t tlv_sz);
+    ssize_t write(uint8_t *to, size_t buf_sz) const;
+    size_t length() const;
+};
+
+}
+
+#endif // LDP_HOP_COUNT_TLV_H
@@ -2,6 +2,7 @@
 #define LDP_IPV4_TRANSPORT_ADDRESS_TLV_H
 #include "core/serializable.hh"
 #include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
 
 namespace ldpd {
 
@@ -11,6 +12,8 @@ public:
     ~LdpIpv4TransportAddressTlvValue();
     uint16_t getType() const;
 
+    static const uint16_t TYPE = LDP_TLVTYPE_IPV4_TRANSPORT;
+
     uint32_t getAddress() const;
     const char* getAddressString() const;
 
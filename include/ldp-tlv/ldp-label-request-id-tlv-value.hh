@@ -0,0 +1,34 @@
+#ifndef LDP_LABEL_REQUEST_ID_TLV_H
+#define LDP_LABEL_REQUEST_ID_TLV_H
+#include "core/serializable.hh"
+#include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
+
+namespace ldpd {
+
+class LdpLabelRequestIdTlvValue : public LdpTlvValue {
+public:
+    LdpLabelRequestIdTlvValue();
+
+    uint16_t getType() const;
+
+    static const uint16_t TYPE = LDP_TLVTYPE_LABEL_REQUEST;
+
+    uint32_t getMessageId() const;
+
+    ssize_t setMessageId(uint32_t id);
+
+private:
+    uint32_t _id;
+
+// ----------------------------------------------------------------------------
+
+public:
+    ssize_t parse(const uint8_t *from, size_t tlv_sz);
+    ssize_t write(uint8_t *to, size_t buf_sz) const;
+    size_t length() const;
+};
+
+}
+
+#endif // LDP_LABEL_REQUEST_ID_TLV_H
@@ -0,0 +1,38 @@
+#ifndef LDP_PATH_VECTOR_TLV_H
+#define LDP_PATH_VECTOR_TLV_H
+#include "core/serializable.hh"
+#include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
+
+#include <vector>
+
+namespace ldpd {
+
+class LdpPathVectorTlvValue : public LdpTlvValue {
+public:
+    LdpPathVectorTlvValue();
+    ~LdpPathVectorTlvValue();
+    uint16_t getType() const;
+
+    static const uint16_t TYPE = LDP_TLVTYPE_PATH_VECTOR;
+
+    const std::vector<uint32_t> getLsrIds() const;
+
+    void clearLsrIds();
+
+    ssize_t addLsrId(uint32_t lsrId);
+
+private:
+    std::vector<uint32_t> _lsr_ids;
+
+// ----------------------------------------------------------------------------
+
+public:
+    ssize_t parse(const uint8_t *from, size_t tlv_sz);
+    ssize_t write(uint8_t *to, size_t buf_sz) const;
+    size_t length() const;
+};
+
+}
+
+#endif // LDP_PATH_VECTOR_TLV_H
@@ -1,13 +1,15 @@
 #ifndef LDP_RAW_TLV_H
 #define LDP_RAW_TLV_H
 #include "core/serializable.hh"
+#include "core/arena.hh"
 #include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-view.hh"
 
 namespace ldpd {
 
-class LdpRawTlv : public Serializable {
+class LdpRawTlv : public Serializable, public ArenaObject {
 public:
-    LdpRawTlv();
+    LdpRawTlv(Arena *arena = nullptr);
     ~LdpRawTlv();
 
     bool unknown() const;
@@ -26,14 +28,46 @@ public:
     
     LdpTlvValue* getParsedValue() const;
 
+    const LdpTlvValue* getCachedValue() const;
+
+    /**
+     * @brief get the parsed value as the given value type. the value is
+     * parsed on first use and kept until the tlv changes.
+     * 
+     * @tparam T value type (LdpFecTlvValue, LdpStatusTlvValue, etc.)
+     * @return const T* value, owned by the tlv. nullptr if the tlv is not
+     * of type T or can't be parsed.
+     */
+    template <typename T> const T* getValue() const {
+        if (getType() != T::TYPE) {
+            return nullptr;
+        }
+
+        return (const T *) getCachedValue();
+    }
+
+    static LdpTlvValue* parseValue(uint16_t type, const uint8_t *value, size_t len, Arena *arena = nullptr);
+
 protected:
+    bool resizeBuffer(size_t size);
+    void freeBuffer();
+    void dropCachedValue();
+
     uint8_t *_raw_buffer;
     size_t _raw_buffer_size; // might not match len field in case of bad pkt.
 
+    // where _raw_buffer is allocated, nullptr for heap.
+    Arena *_arena;
+
+    // value parsed by getCachedValue(), dropped when the tlv changes.
+    mutable LdpTlvValue *_value;
+    mutable bool _value_parsed;
+
 // ----------------------------------------------------------------------------
 
 public:
     ssize_t parse(const uint8_t *from, size_t msg_sz);
+    ssize_t parse(const LdpTlvView &tlv);
     ssize_t write(uint8_t *to, size_t buf_sz) const;
     size_t length() const;
 };
@@ -2,6 +2,7 @@
 #define LDP_STATUS_TLV_H
 #include "core/serializable.hh"
 #include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
 
 namespace ldpd {
 
@@ -38,6 +39,8 @@ public:
     ~LdpStatusTlvValue();
     uint16_t getType() const;
 
+    static const uint16_t TYPE = LDP_TLVTYPE_STATUS;
+
     uint32_t getStatusCode() const;
     uint32_t getMessageId() const;
     uint16_t getMessageType() const;
@@ -0,0 +1,86 @@
+#ifndef LDP_TLV_REGISTRY_H
+#define LDP_TLV_REGISTRY_H
+#include "ldp-tlv/ldp-type-registry.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
+#include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-tlv/ldp-fec-element.hh"
+#include "ldp-tlv/ldp-fec-tlv-value.hh"
+#include "ldp-tlv/ldp-fec-wildcard-element.hh"
+#include "ldp-tlv/ldp-fec-prefix-element.hh"
+#include "ldp-tlv/ldp-fec-typed-wildcard-element.hh"
+#include "ldp-tlv/ldp-address-tlv-value.hh"
+#include "ldp-tlv/ldp-hop-count-tlv-value.hh"
+#include "ldp-tlv/ldp-path-vector-tlv-value.hh"
+#include "ldp-tlv/ldp-generic-label-tlv-value.hh"
+#include "ldp-tlv/ldp-status-tlv-value.hh"
+#include "ldp-tlv/ldp-common-hello-params-tlv-value.hh"
+#include "ldp-tlv/ldp-ipv4-transport-address-tlv-value.hh"
+#include "ldp-tlv/ldp-config-seq-num-tlv-value.hh"
+#include "ldp-tlv/ldp-common-session-params-tlv-value.hh"
+#include "ldp-tlv/ldp-label-request-id-tlv-value.hh"
+
+namespace ldpd {
+
+/**
+ * @brief slots for tlv types. the tlv types we know are 0x0X0Y w/ X and Y
+ * below 8, so the slot is XY in octal: 64 slots, no collision. a type w/ the
+ * u or f bit set, or outside of that range, is not known.
+ */
+struct LdpTlvRegistryTraits {
+    typedef LdpTlvValue Base;
+
+    static const size_t SLOTS = 64;
+
+    static constexpr bool fits(uint16_t type) {
+        return (type & ~0x0707) == 0;
+    }
+
+    static constexpr size_t slot(uint16_t type) {
+        return ((type >> 5) & 0x38) | (type & 0x07);
+    }
+};
+
+/**
+ * @brief slots for fec element types: element types below 8 map to
+ * themselves.
+ */
+struct LdpFecRegistryTraits {
+    typedef LdpFecElement Base;
+
+    static const size_t SLOTS = 8;
+
+    static constexpr bool fits(uint16_t type) {
+        return type < SLOTS;
+    }
+
+    static constexpr size_t slot(uint16_t type) {
+        return type;
+    }
+};
+
+// tlv values LdpRawTlv::parseValue can decode. to support a new tlv, give its
+// value class a static TYPE and add it here.
+typedef LdpTypeRegistry<LdpTlvRegistryTraits,
+    LdpFecTlvValue,
+    LdpAddressTlvValue,
+    LdpHopCountTlvValue,
+    LdpPathVectorTlvValue,
+    LdpGenericLabelTlvValue,
+    LdpStatusTlvValue,
+    LdpCommonHelloParamsTlvValue,
+    LdpIpv4TransportAddressTlvValue,
+    LdpConfigSeqNumTlvValue,
+    LdpCommonSessionParamsTlvValue,
+    LdpLabelRequestIdTlvValue
+> LdpTlvRegistry;
+
+// fec elements LdpFecTlvValue can decode.
+typedef LdpTypeRegistry<LdpFecRegistryTraits,
+    LdpFecWildcardElement,
+    LdpFecPrefixElement,
+    LdpFecTypedWildcardElement
+> LdpFecRegistry;
+
+}
+
+#endif // LDP_TLV_REGISTRY_H
@@ -16,4 +16,8 @@
 #define LDP_TLVTYPE_COMMON_SESSION 0x0500
 #define LDP_TLVTYPE_ATM_SESSION 0x0501
 #define LDP_TLVTYPE_FR_SESSION 0x0502
-#define LDP_TLVTYPE_LABEL_REQUEST 0x0600
\ No newline at end of file
+#define LDP_TLVTYPE_LABEL_REQUEST 0x0600
+
+#define LDP_FEC_WILDCARD 0x01
+#define LDP_FEC_PREFIX 0x02
+#define LDP_FEC_TYPED_WILDCARD 0x05
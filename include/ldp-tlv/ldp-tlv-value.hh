@@ -1,10 +1,11 @@
 #ifndef LDP_TLV_VALUE_H
 #define LDP_TLV_VALUE_H
 #include "core/serializable.hh"
+#include "core/arena.hh"
 
 namespace ldpd {
 
-class LdpTlvValue : public Serializable {
+class LdpTlvValue : public Serializable, public ArenaObject {
 public:
     virtual ~LdpTlvValue() {};
     virtual uint16_t getType() const = 0;
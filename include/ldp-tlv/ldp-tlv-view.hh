@@ -0,0 +1,66 @@
+#ifndef LDP_TLV_VIEW_H
+#define LDP_TLV_VIEW_H
+#include "ldp-tlv/ldp-tlv-value.hh"
+#include "ldp-pdu/ldp-parse-error.hh"
+
+#include <stdint.h>
+#include <unistd.h>
+
+// type + length field.
+#define LDP_TLV_HDR_LEN 4
+
+namespace ldpd {
+
+/**
+ * @brief read-only view of a tlv in a receive buffer.
+ *
+ * unlike LdpRawTlv, this does not copy the tlv - it only points into the
+ * buffer it was made from, and is valid for as long as that buffer is.
+ */
+class LdpTlvView {
+public:
+    LdpTlvView();
+    LdpTlvView(const uint8_t *tlv, size_t len);
+
+    bool valid() const;
+
+    bool unknown() const;
+    bool forwardUnknown() const;
+
+    uint16_t getType() const;
+    uint16_t getLength() const;
+
+    const uint8_t* getValue() const;
+
+    const uint8_t* data() const;
+    size_t size() const;
+
+    LdpTlvValue* getParsedValue() const;
+    ssize_t parseValue(LdpTlvValue &into, LdpParseError *err = nullptr) const;
+
+private:
+    const uint8_t *_tlv;
+    size_t _len;
+};
+
+/**
+ * @brief iterate over the tlvs in a buffer that was already checked to be a
+ * valid sequence of tlvs (see LdpMessageView::parse).
+ */
+class LdpTlvIterator {
+public:
+    LdpTlvIterator(const uint8_t *at, const uint8_t *end);
+
+    LdpTlvView operator*() const;
+    LdpTlvIterator& operator++();
+
+    bool operator!=(const LdpTlvIterator &other) const;
+
+private:
+    const uint8_t *_at;
+    const uint8_t *_end;
+};
+
+}
+
+#endif // LDP_TLV_VIEW_H
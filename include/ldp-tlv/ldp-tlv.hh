@@ -6,10 +6,17 @@
 #include "ldp-tlv/ldp-fec-element.hh"
 #include "ldp-tlv/ldp-fec-wildcard-element.hh"
 #include "ldp-tlv/ldp-fec-prefix-element.hh"
+#include "ldp-tlv/ldp-fec-typed-wildcard-element.hh"
 #include "ldp-tlv/ldp-address-tlv-value.hh"
 #include "ldp-tlv/ldp-common-hello-params-tlv-value.hh"
 #include "ldp-tlv/ldp-config-seq-num-tlv-value.hh"
 #include "ldp-tlv/ldp-ipv4-transport-address-tlv-value.hh"
 #include "ldp-tlv/ldp-common-session-params-tlv-value.hh"
 #include "ldp-tlv/ldp-config-seq-num-tlv-value.hh"
-#include "ldp-tlv/ldp-status-tlv-value.hh"
\ No newline at end of file
+#include "ldp-tlv/ldp-status-tlv-value.hh"
+#include "ldp-tlv/ldp-hop-count-tlv-value.hh"
+#include "ldp-tlv/ldp-path-vector-tlv-value.hh"
+#include "ldp-tlv/ldp-label-request-id-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-view.hh"
+#include "ldp-tlv/ldp-fec-view.hh"
+#include "ldp-tlv/ldp-tlv-registry.hh"
\ No newline at end of file
@@ -0,0 +1,157 @@
+#ifndef LDP_TYPE_REGISTRY_H
+#define LDP_TYPE_REGISTRY_H
+#include "core/arena.hh"
+
+#include <stdint.h>
+#include <unistd.h>
+#include <type_traits>
+
+namespace ldpd {
+
+/**
+ * @brief map type codes to the classes that decode them, at compile time.
+ *
+ * LdpTypeRegistry<Traits, T...> builds a table of Traits::SLOTS entries,
+ * one per slot, where the slot of a type code is Traits::slot(code). each
+ * class T has a static TYPE member with its code; the entry in its slot
+ * holds the code and a function creating a T. lookup is: check the code
+ * fits (Traits::fits), index the table, compare the code - no search, no
+ * branch per registered type.
+ *
+ * every code registered must fit, and no two classes may have the same
+ * code; both are checked at compile time.
+ *
+ * Traits must have:
+ * - Base: the common base class of T...,
+ * - SLOTS: size of the table,
+ * - constexpr bool fits(uint16_t code): code maps to a slot of its own,
+ * - constexpr size_t slot(uint16_t code): the slot of code.
+ */
+
+template <typename Base> struct LdpRegistryEntry {
+    uint16_t type;
+    Base* (*create)(Arena *arena);
+};
+
+// classes taking an arena in their constructor (e.g. those holding other
+// arena objects) get it, others are just placed in it.
+
+template <typename Base, typename T> Base* ldpCreateInArena(Arena *arena, std::true_type) {
+    return new (arena) T(arena);
+}
+
+template <typename Base, typename T> Base* ldpCreateInArena(Arena *arena, std::false_type) {
+    return new (arena) T();
+}
+
+template <typename Base, typename T> Base* ldpCreate(Arena *arena) {
+    return ldpCreateInArena<Base, T>(arena, typename std::is_constructible<T, Arena *>::type());
+}
+
+template <typename Traits, typename... Ts> struct LdpRegistryLookup;
+
+template <typename Traits> struct LdpRegistryLookup<Traits> {
+    typedef typename Traits::Base Base;
+
+    static constexpr LdpRegistryEntry<Base> at(size_t) {
+        return LdpRegistryEntry<Base> { 0, nullptr };
+    }
+
+    static constexpr size_t count(uint16_t) {
+        return 0;
+    }
+
+    static constexpr bool valid() {
+        return true;
+    }
+};
+
+template <typename Traits, typename T, typename... Ts> struct LdpRegistryLookup<Traits, T, Ts...> {
+    typedef typename Traits::Base Base;
+
+    static_assert(std::is_base_of<Base, T>::value, "registered class must derive from the registry base.");
+
+    // entry for the given slot.
+    static constexpr LdpRegistryEntry<Base> at(size_t slot) {
+        return Traits::slot(T::TYPE) == slot ? LdpRegistryEntry<Base> { T::TYPE, &ldpCreate<Base, T> } : LdpRegistryLookup<Traits, Ts...>::at(slot);
+    }
+
+    // number of classes registered w/ the given code.
+    static constexpr size_t count(uint16_t code) {
+        return (T::TYPE == code ? 1 : 0) + LdpRegistryLookup<Traits, Ts...>::count(code);
+    }
+
+    static constexpr bool valid() {
+        return Traits::fits(T::TYPE) && LdpRegistryLookup<Traits, Ts...>::count(T::TYPE) == 0 && LdpRegistryLookup<Traits, Ts...>::valid();
+    }
+};
+
+template <size_t... I> struct LdpIndexSequence {};
+
+template <size_t N, size_t... I> struct LdpMakeIndexSequence : LdpMakeIndexSequence<N - 1, N - 1, I...> {};
+
+template <size_t... I> struct LdpMakeIndexSequence<0, I...> {
+    typedef LdpIndexSequence<I...> type;
+};
+
+template <typename Traits, typename Seq, typename... Ts> struct LdpRegistryTable;
+
+template <typename Traits, size_t... I, typename... Ts> struct LdpRegistryTable<Traits, LdpIndexSequence<I...>, Ts...> {
+    static constexpr LdpRegistryEntry<typename Traits::Base> entries[sizeof...(I)] = { LdpRegistryLookup<Traits, Ts...>::at(I)... };
+};
+
+template <typename Traits, size_t... I, typename... Ts>
+constexpr LdpRegistryEntry<typename Traits::Base> LdpRegistryTable<Traits, LdpIndexSequence<I...>, Ts...>::entries[sizeof...(I)];
+
+template <typename Traits, typename... Ts> class LdpTypeRegistry {
+public:
+    typedef typename Traits::Base Base;
+
+    static_assert(LdpRegistryLookup<Traits, Ts...>::valid(), "type code does not fit the registry, or registered twice.");
+
+    /**
+     * @brief create an (empty) object for the given type code.
+     *
+     * @param type type code.
+     * @param arena arena to allocate the object from, nullptr for heap.
+     * @return Base* new object, or nullptr if no class is registered for the
+     * type.
+     */
+    static Base* create(uint16_t type, Arena *arena = nullptr) {
+        if (!Traits::fits(type)) {
+            return nullptr;
+        }
+
+        const LdpRegistryEntry<Base> &entry = Table::entries[Traits::slot(type)];
+
+        if (entry.create == nullptr || entry.type != type) {
+            return nullptr;
+        }
+
+        return entry.create(arena);
+    }
+
+    /**
+     * @brief test if a class is registered for the given type code.
+     *
+     * @param type type code.
+     * @return true if registered.
+     * @return false if not.
+     */
+    static bool known(uint16_t type) {
+        if (!Traits::fits(type)) {
+            return false;
+        }
+
+        const LdpRegistryEntry<Base> &entry = Table::entries[Traits::slot(type)];
+
+        return entry.create != nullptr && entry.type == type;
+    }
+
+private:
+    typedef LdpRegistryTable<Traits, typename LdpMakeIndexSequence<Traits::SLOTS>::type, Ts...> Table;
+};
+
+}
+
+#endif // LDP_TYPE_REGISTRY_H
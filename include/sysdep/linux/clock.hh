@@ -0,0 +1,37 @@
+#ifndef LDP_CLOCK_H
+#define LDP_CLOCK_H
+#include <stdint.h>
+
+namespace ldpd {
+
+/**
+ * @brief monotonic millisecond clock. the timerfd becomes readable when the
+ * time set with arm() is reached, so the event loop can wait on it together
+ * with the sockets.
+ */
+class Clock {
+public:
+    Clock();
+    ~Clock();
+
+    int open();
+    int close();
+
+    int getFd() const;
+
+    int arm(uint64_t at);
+    int disarm();
+    void ack();
+
+    static uint64_t now();
+
+private:
+    int _fd;
+
+    // time the timerfd is armed for, 0 if not armed.
+    uint64_t _armed;
+};
+
+}
+
+#endif // LDP_CLOCK_H
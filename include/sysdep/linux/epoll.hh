@@ -0,0 +1,28 @@
+#ifndef LDP_EPOLL_H
+#define LDP_EPOLL_H
+#include <stdint.h>
+#include <sys/epoll.h>
+
+namespace ldpd {
+
+class Epoll {
+public:
+    Epoll();
+    ~Epoll();
+
+    int open();
+    int close();
+
+    int add(int fd, uint32_t events);
+    int modify(int fd, uint32_t events);
+    int remove(int fd);
+
+    int wait(struct epoll_event *events, int maxEvents, int timeout);
+
+private:
+    int _fd;
+};
+
+}
+
+#endif // LDP_EPOLL_H
@@ -44,6 +44,8 @@ public:
     int open();
     int close();
 
+    int getFd() const;
+
     int getInterfaces(std::vector<Interface> &to);
 
     int getRoutes(std::vector<Ipv4Route> &to);
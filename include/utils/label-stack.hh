@@ -0,0 +1,23 @@
+#ifndef LDP_LABEL_STACK_H
+#define LDP_LABEL_STACK_H
+#include <stdint.h>
+#include <unistd.h>
+
+namespace ldpd {
+
+// convert between labels (20-bit values in host byte order) and mpls label
+// stack entries as the kernel wants them (network byte order, label in the
+// top 20 bits, bottom-of-stack bit set on the last entry, tc and ttl 0).
+//
+// the plain versions pick the fastest implementation the cpu supports; the
+// *Scalar ones are the portable fallback, exposed for testing.
+
+void encodeLabelStack(uint32_t *to, const uint32_t *labels, size_t count);
+void decodeLabelStack(uint32_t *labels, const void *from, size_t count);
+
+void encodeLabelStackScalar(uint32_t *to, const uint32_t *labels, size_t count);
+void decodeLabelStackScalar(uint32_t *labels, const void *from, size_t count);
+
+}
+
+#endif // LDP_LABEL_STACK_H
@@ -0,0 +1,42 @@
+#ifndef LDP_LOG_LIMITER_H
+#define LDP_LOG_LIMITER_H
+#include <stdint.h>
+#include <unistd.h>
+
+// default: at most this many messages...
+#define LDP_LOG_LIMIT_BURST 5
+
+// ...per this many ms.
+#define LDP_LOG_LIMIT_INTERVAL 10000
+
+namespace ldpd {
+
+/**
+ * @brief rate limit for log messages a peer can trigger at will (e.g. by
+ * sending garbage), so it can't flood the log or slow the daemon down.
+ *
+ * allow() says if a message may be logged now; the ones that may not are
+ * counted, and takeSuppressed() gives the count to report with the next
+ * message that is logged.
+ */
+class LogLimiter {
+public:
+    LogLimiter(uint32_t burst = LDP_LOG_LIMIT_BURST, uint64_t interval = LDP_LOG_LIMIT_INTERVAL);
+
+    bool allow(uint64_t now);
+    uint32_t takeSuppressed();
+
+private:
+    uint32_t _burst;
+    uint64_t _interval;
+
+    // start of the current interval, and messages allowed in it so far.
+    uint64_t _start;
+    uint32_t _count;
+
+    uint32_t _suppressed;
+};
+
+}
+
+#endif // LDP_LOG_LIMITER_H
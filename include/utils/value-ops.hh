@@ -23,7 +23,6 @@ template <typename T> ssize_t getValue(const uint8_t *src, size_t src_sz, T &dst
     size_t sz = sizeof(T);
     
     if (sz > src_sz) {
-        log_fatal("unexpected end of buffer when reading value: souce buffer size: %zu, variable size %zu\n", src_sz, sz);
         return -1;
     }
 
@@ -55,14 +54,14 @@ template <typename T> size_t putValue(uint8_t *dst, size_t dst_sz, const T &valu
 }
 
 #define GETVAL_S(buf_ptr, buf_sz_var, dst_var_type, dst_var, post_processing, err_ret) {\
-    ssize_t tmp = getValue<dst_var_type>(buf_ptr, buf_sz_var, dst_var);\
+    ssize_t tmp = ::ldpd::getValue<dst_var_type>(buf_ptr, buf_sz_var, dst_var);\
     dst_var = post_processing(dst_var);\
     if (tmp < 0) { return err_ret; };\
     buf_sz_var -= tmp; buf_ptr += tmp;\
 }
 
 #define PUTVAL_S(buf_ptr, buf_sz_var, src_var_type, src_var, pre_processing, err_ret) {\
-    ssize_t tmp = putValue<src_var_type>(buf_ptr, buf_sz_var, pre_processing(src_var));\
+    ssize_t tmp = ::ldpd::putValue<src_var_type>(buf_ptr, buf_sz_var, pre_processing(src_var));\
     if (tmp < 0) { return err_ret; };\
     buf_sz_var -= tmp; buf_ptr += tmp;\
 }
@@ -0,0 +1,185 @@
+#include "utils/log.hh"
+#include "core/arena.hh"
+
+#include <string.h>
+
+namespace ldpd {
+
+Arena::Arena() : _blocks(), _large() {
+    _current = 0;
+    _offset = 0;
+    _used = 0;
+}
+
+Arena::Arena(__attribute__((unused)) const Arena &other) : Arena() {
+}
+
+Arena::~Arena() {
+    release();
+}
+
+/**
+ * @brief allocate memory from the arena.
+ *
+ * @param size bytes wanted.
+ * @return void* memory aligned to LDP_ARENA_ALIGN, or nullptr if out of
+ * memory.
+ */
+void* Arena::allocate(size_t size) {
+    size = (size + LDP_ARENA_ALIGN - 1) & ~((size_t) LDP_ARENA_ALIGN - 1);
+
+    if (size == 0) {
+        size = LDP_ARENA_ALIGN;
+    }
+
+    if (size > LDP_ARENA_BLOCK_SIZE / 4) {
+        return allocateLarge(size);
+    }
+
+    while (_current < _blocks.size() && _blocks[_current].size - _offset < size) {
+        ++_current;
+        _offset = 0;
+    }
+
+    if (_current == _blocks.size()) {
+        Block block;
+
+        block.data = (uint8_t *) malloc(LDP_ARENA_BLOCK_SIZE);
+        block.size = LDP_ARENA_BLOCK_SIZE;
+
+        if (block.data == nullptr) {
+            log_error("malloc(): can not allocate arena block.\n");
+            return nullptr;
+        }
+
+        _blocks.push_back(block);
+        _offset = 0;
+    }
+
+    void *ptr = _blocks[_current].data + _offset;
+
+    _offset += size;
+    _used += size;
+
+    return ptr;
+}
+
+/**
+ * @brief give back everything allocated from the arena. regular blocks are
+ * kept for the next round of allocations.
+ */
+void Arena::reset() {
+    for (Block &block : _large) {
+        free(block.data);
+    }
+
+    _large.clear();
+
+    _current = 0;
+    _offset = 0;
+    _used = 0;
+}
+
+/**
+ * @brief give back everything allocated from the arena, and free all blocks.
+ */
+void Arena::release() {
+    reset();
+
+    for (Block &block : _blocks) {
+        free(block.data);
+    }
+
+    _blocks.clear();
+}
+
+/**
+ * @brief get number of bytes allocated since the last reset.
+ *
+ * @return size_t bytes.
+ */
+size_t Arena::used() const {
+    return _used;
+}
+
+/**
+ * @brief get number of bytes held by the arena.
+ *
+ * @return size_t bytes.
+ */
+size_t Arena::capacity() const {
+    size_t cap = 0;
+
+    for (const Block &block : _blocks) {
+        cap += block.size;
+    }
+
+    for (const Block &block : _large) {
+        cap += block.size;
+    }
+
+    return cap;
+}
+
+void* Arena::allocateLarge(size_t size) {
+    Block block;
+
+    block.data = (uint8_t *) malloc(size);
+    block.size = size;
+
+    if (block.data == nullptr) {
+        log_error("malloc(): can not allocate %zu bytes from arena.\n", size);
+        return nullptr;
+    }
+
+    _large.push_back(block);
+    _used += size;
+
+    return block.data;
+}
+
+// objects are prefixed w/ the arena they came from (nullptr for heap), padded
+// so the object itself stays aligned.
+
+void* ArenaObject::operator new(size_t size) {
+    return ArenaObject::operator new(size, nullptr);
+}
+
+void* ArenaObject::operator new(size_t size, Arena *arena) {
+    uint8_t *ptr;
+
+    if (arena != nullptr) {
+        ptr = (uint8_t *) arena->allocate(LDP_ARENA_ALIGN + size);
+    } else {
+        ptr = (uint8_t *) malloc(LDP_ARENA_ALIGN + size);
+    }
+
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    memcpy(ptr, &arena, sizeof(arena));
+
+    return ptr + LDP_ARENA_ALIGN;
+}
+
+void ArenaObject::operator delete(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    uint8_t *base = (uint8_t *) ptr - LDP_ARENA_ALIGN;
+    Arena *arena;
+
+    memcpy(&arena, base, sizeof(arena));
+
+    if (arena == nullptr) {
+        free(base);
+    }
+}
+
+void ArenaObject::operator delete(void *ptr, __attribute__((unused)) Arena *arena) {
+    ArenaObject::operator delete(ptr);
+}
+
+}
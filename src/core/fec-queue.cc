@@ -0,0 +1,56 @@
+#include "core/fec-queue.hh"
+
+namespace ldpd {
+
+FecQueue::FecQueue() : _queue(), _queued() {
+
+}
+
+/**
+ * @brief queue a fec, unless it is queued already.
+ *
+ * @param fec the fec.
+ * @return true if queued, false if it was already.
+ */
+bool FecQueue::push(const Prefix &fec) {
+    if (!_queued.insert(fec).second) {
+        return false;
+    }
+
+    _queue.push_back(fec);
+
+    return true;
+}
+
+/**
+ * @brief get the fec queued first. the queue must not be empty.
+ *
+ * @return const Prefix& the fec.
+ */
+const Prefix& FecQueue::front() const {
+    return _queue.front();
+}
+
+void FecQueue::pop() {
+    _queued.erase(_queue.front());
+    _queue.pop_front();
+}
+
+bool FecQueue::contains(const Prefix &fec) const {
+    return _queued.count(fec) != 0;
+}
+
+bool FecQueue::empty() const {
+    return _queue.empty();
+}
+
+size_t FecQueue::size() const {
+    return _queue.size();
+}
+
+void FecQueue::clear() {
+    _queue.clear();
+    _queued.clear();
+}
+
+}
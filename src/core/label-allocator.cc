@@ -0,0 +1,230 @@
+#include "utils/log.hh"
+#include "core/label-allocator.hh"
+
+namespace ldpd {
+
+LabelAllocator::LabelAllocator(uint32_t min, uint32_t max) : _levels(), _reserved() {
+    if (max < min) {
+        log_error("bad label range %u - %u, using %u - %u.\n", min, max, LDP_MIN_LBL, LDP_MAX_LBL);
+        min = LDP_MIN_LBL;
+        max = LDP_MAX_LBL;
+    }
+
+    _min = min;
+    _max = max;
+    _allocated = 0;
+    _free = (size_t) max - min + 1;
+
+    size_t bits = _free;
+
+    // every bit of each level set: all labels free, every word non-empty.
+    do {
+        size_t words = (bits + 63) / 64;
+
+        std::vector<uint64_t> level = std::vector<uint64_t>(words, ~(uint64_t) 0);
+
+        if (bits % 64 != 0) {
+            level[words - 1] = ((uint64_t) 1 << (bits % 64)) - 1;
+        }
+
+        _levels.push_back(level);
+        bits = words;
+    } while (bits > 1);
+}
+
+/**
+ * @brief get a free label - the lowest one.
+ *
+ * @return uint32_t the label, or LDP_LABEL_NONE if none is left.
+ */
+uint32_t LabelAllocator::allocate() {
+    if (_levels.back()[0] == 0) {
+        log_error("we have run out of labels.\n");
+        return LDP_LABEL_NONE;
+    }
+
+    size_t index = 0;
+
+    for (size_t level = _levels.size(); level > 0; --level) {
+        index = index * 64 + __builtin_ctzll(_levels[level - 1][index]);
+    }
+
+    markUsed(index);
+    ++_allocated;
+
+    return _min + index;
+}
+
+/**
+ * @brief give a label from allocate() back.
+ *
+ * @param label the label.
+ * @return int 0 on success, -1 if the label was not allocated.
+ */
+int LabelAllocator::release(uint32_t label) {
+    if (label < _min || label > _max || !used(label)) {
+        log_warn("label %u was not allocated.\n", label);
+        return -1;
+    }
+
+    if (findReserved(label) != nullptr) {
+        log_warn("label %u is reserved, not allocated.\n", label);
+        return -1;
+    }
+
+    markFree(label - _min);
+    --_allocated;
+
+    return 0;
+}
+
+/**
+ * @brief reserve a block of labels, so they are not handed out.
+ *
+ * @param first first label of the block.
+ * @param count number of labels.
+ * @return int 0 on success, -1 if the block is not in the range or some of
+ * it is in use.
+ */
+int LabelAllocator::reserve(uint32_t first, uint32_t count) {
+    if (count == 0 || first < _min || first > _max || count - 1 > _max - first) {
+        log_error("label block %u (%u labels) not in range %u - %u.\n", first, count, _min, _max);
+        return -1;
+    }
+
+    for (uint32_t label = first; label - first < count; ++label) {
+        if (used(label)) {
+            log_error("label block %u (%u labels): label %u in use.\n", first, count, label);
+            return -1;
+        }
+    }
+
+    for (uint32_t label = first; label - first < count; ++label) {
+        markUsed(label - _min);
+    }
+
+    Block block;
+    block.first = first;
+    block.count = count;
+
+    _reserved.push_back(block);
+
+    return 0;
+}
+
+/**
+ * @brief give a block from reserve() back.
+ *
+ * @param first first label of the block.
+ * @param count number of labels, as it was reserved.
+ * @return int 0 on success, -1 if no such block is reserved.
+ */
+int LabelAllocator::unreserve(uint32_t first, uint32_t count) {
+    for (std::vector<Block>::iterator it = _reserved.begin(); it != _reserved.end(); ++it) {
+        if (it->first != first || it->count != count) {
+            continue;
+        }
+
+        for (uint32_t label = first; label - first < count; ++label) {
+            markFree(label - _min);
+        }
+
+        _reserved.erase(it);
+
+        return 0;
+    }
+
+    log_error("label block %u (%u labels) is not reserved.\n", first, count);
+
+    return -1;
+}
+
+/**
+ * @brief test if a label is allocated or reserved.
+ *
+ * @param label the label.
+ * @return true if it is, or it is out of the range.
+ * @return false if it is free.
+ */
+bool LabelAllocator::used(uint32_t label) const {
+    if (label < _min || label > _max) {
+        return true;
+    }
+
+    size_t index = label - _min;
+
+    return (_levels[0][index / 64] & ((uint64_t) 1 << (index % 64))) == 0;
+}
+
+uint32_t LabelAllocator::getMinLabel() const {
+    return _min;
+}
+
+uint32_t LabelAllocator::getMaxLabel() const {
+    return _max;
+}
+
+/**
+ * @brief get number of labels handed out by allocate() and not released.
+ *
+ * @return size_t labels.
+ */
+size_t LabelAllocator::allocated() const {
+    return _allocated;
+}
+
+/**
+ * @brief get number of labels allocate() can still hand out.
+ *
+ * @return size_t labels.
+ */
+size_t LabelAllocator::available() const {
+    return _free;
+}
+
+void LabelAllocator::markUsed(size_t index) {
+    --_free;
+
+    // clear the bit; if the word becomes empty, clear its bit a level up.
+    for (size_t level = 0; level < _levels.size(); ++level) {
+        uint64_t &word = _levels[level][index / 64];
+
+        word &= ~((uint64_t) 1 << (index % 64));
+
+        if (word != 0) {
+            break;
+        }
+
+        index /= 64;
+    }
+}
+
+void LabelAllocator::markFree(size_t index) {
+    ++_free;
+
+    // set the bit; if the word was empty, set its bit a level up.
+    for (size_t level = 0; level < _levels.size(); ++level) {
+        uint64_t &word = _levels[level][index / 64];
+        bool was_empty = word == 0;
+
+        word |= (uint64_t) 1 << (index % 64);
+
+        if (!was_empty) {
+            break;
+        }
+
+        index /= 64;
+    }
+}
+
+const LabelAllocator::Block* LabelAllocator::findReserved(uint32_t label) const {
+    for (const Block &block : _reserved) {
+        if (label >= block.first && label - block.first < block.count) {
+            return &block;
+        }
+    }
+
+    return nullptr;
+}
+
+}
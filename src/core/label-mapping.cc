@@ -12,14 +12,26 @@ LdpLabelMapping::LdpLabelMapping() : fec() {
 }
 
 bool LdpLabelMapping::operator==(const LdpLabelMapping &other) const {
-    return remote == other.remote && (remote ? (fec == other.fec) : (in_label == other.in_label));
+    return remote == other.remote && fec == other.fec;
 }
 
 bool LdpLabelMapping::operator<(const LdpLabelMapping &other) const {
-    uint64_t self_val = (remote ? 0xfffff : 0) + out_label + in_label;
-    uint64_t other_val = (other.remote ? 0xfffff : 0) + other.out_label + other.in_label;
+    if (remote != other.remote) {
+        return !remote;
+    }
 
-    return self_val < other_val;
+    if (fec.prefix != other.fec.prefix) {
+        return fec.prefix < other.fec.prefix;
+    }
+
+    return fec.len < other.fec.len;
+}
+
+size_t LdpLabelMappingHash::operator()(const LdpLabelMapping &mapping) const {
+    uint64_t key = ((uint64_t) mapping.fec.prefix << 9) | ((uint64_t) mapping.fec.len << 1) | (mapping.remote ? 1 : 0);
+
+    // same multiplicative hash as PrefixHash.
+    return (key * 0x9e3779b97f4a7c15ULL) >> 24;
 }
 
 }
\ No newline at end of file
@@ -3,40 +3,89 @@
 #include "core/ldpd.hh"
 #include "ldp-fsm/ldp-fsm.hh"
 #include "ldp-tlv/ldp-tlv.hh"
+#include "ldp-pdu/ldp-pdu-view.hh"
 
 #include <sys/types.h>
 #include <sys/socket.h>
-#include <sys/select.h>
+#include <poll.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <string.h>
 #include <errno.h>
+#include <inttypes.h>
 
 #include <algorithm>
 
 namespace ldpd {
 
+/**
+ * @brief check w/o blocking or consuming anything whether fd has more input
+ * (datagrams, bytes or connections) waiting.
+ *
+ * @param fd socket.
+ * @return true if there is input left.
+ */
+static bool inputPending(int fd) {
+    struct pollfd pfd;
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    return poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN);
+}
+
+LdpHelloBatch::LdpHelloBatch() {
+    memset(msgs, 0, sizeof(msgs));
+    memset(remotes, 0, sizeof(remotes));
+
+    for (int i = 0; i < LDP_HELLO_BATCH; ++i) {
+        iovs[i].iov_base = buffers[i];
+        iovs[i].iov_len = sizeof(buffers[i]);
+
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &remotes[i];
+        msgs[i].msg_hdr.msg_control = controls[i];
+    }
+}
+
 Ldpd::Ldpd(uint32_t routerId, uint16_t labelSpace, Router *router, int metric) : 
-    _import(FilterAction::Reject), _export(FilterAction::Accept), _ldp_ifaces(),
-    _fsms(), _fds(), _hellos(), _holds(), _transports(), _addresses(),
-    _mappings(), _rejected_mappings(), _pending_delete_mappings(), _ifaces(),
-    _srcs() {
+    _timers(Clock::now()), _import(FilterAction::Reject), _export(FilterAction::Accept), _ldp_ifaces(),
+    _fsms(), _fds(), _tx_pending(), _tx_wait(), _closed(), _connects(), _backoffs(), _hellos(), _holds(), _transports(), _addresses(),
+    _mappings(), _rejected_mappings(), _pending_delete_mappings(), _dirty(), _unresolved(), _export_queues(), _labels(), _ifaces(),
+    _srcs(), _hello_timer(), _scan_timer(), _housekeeping_timer(), _clock(), _parse_log(), _pdu_arena(), _ev(), _stats(), _stats_reported() {
 
     _running = false;
     _id = routerId;
     _space = labelSpace;
     _transport = _id;
 
-    _hold = 15;
-    _hello = 5;
-    _keep = 45;
-    _ifscan = 300;
+    _hold = LDP_DEF_LINK_HOLD;
+    _hello = LDP_DEF_HELLO_INTERVAL;
+    _keep = LDP_DEF_KEEPALIVE;
+    _max_pdu = LDP_DEF_MAX_PDU_LEN;
+    _ifscan = LDP_DEF_IFSCAN_INTERVAL;
 
     _tfd = -1;
     _ufd = -1;
 
+    _hello_batch = nullptr;
+
+    _hello_pdu = nullptr;
+    _hello_len = 0;
+    _hello_dirty = true;
+
+    // FIXME: track local config change.
+    _config_seq = 114514;
+
     _last_hello = 0;
-    _now = time(nullptr);
+    _hello_interval = _hello;
+    _now = Clock::now();
+
+    _hello_timer.setHandler(Ldpd::handleHelloTimer, this);
+    _scan_timer.setHandler(Ldpd::handleScanTimer, this);
+    _housekeeping_timer.setHandler(Ldpd::handleHousekeepingTimer, this);
 
     _router = router;
 
@@ -49,6 +98,14 @@ Ldpd::Ldpd(uint32_t routerId, uint16_t labelSpace, Router *router, int metric) :
 
 Ldpd::~Ldpd() {
     stop();
+
+    if (_hello_batch != nullptr) {
+        delete _hello_batch;
+    }
+
+    if (_hello_pdu != nullptr) {
+        free(_hello_pdu);
+    }
 }
 
 void Ldpd::addInterface(std::string ifname) {
@@ -91,7 +148,7 @@ int Ldpd::start() {
     addr.sin_addr.s_addr = htonl(INADDR_ANY);
     addr.sin_port = htons(LDP_PORT);
 
-    _tfd = socket(AF_INET, SOCK_STREAM, 0);
+    _tfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
 
     if (_tfd < 0) {
         log_fatal("socket(): %s.\n", strerror(errno));
@@ -118,7 +175,7 @@ int Ldpd::start() {
         return 1;
     }
 
-    _ufd = socket(AF_INET, SOCK_DGRAM, 0);
+    _ufd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
 
     if (_ufd < 0) {
         log_fatal("socket(): %s.\n", strerror(errno));
@@ -153,6 +210,31 @@ int Ldpd::start() {
         return 1;
     }
 
+    if (_ev.open() != 0 || _clock.open() != 0) {
+        return 1;
+    }
+
+    if (_ev.add(_tfd, EPOLLIN) != 0 || _ev.add(_ufd, EPOLLIN) != 0 || _ev.add(_clock.getFd(), EPOLLIN) != 0) {
+        return 1;
+    }
+
+    if (_router->getFd() >= 0 && _ev.add(_router->getFd(), EPOLLIN) != 0) {
+        return 1;
+    }
+
+    if (_hello_batch == nullptr) {
+        _hello_batch = new LdpHelloBatch();
+    }
+
+    _now = Clock::now();
+    _timers.advance(_now);
+
+    updateHelloInterval();
+
+    _timers.schedule(&_hello_timer, _now);
+    _timers.schedule(&_scan_timer, _now + _ifscan);
+    _timers.schedule(&_housekeeping_timer, _now);
+
     _running = true;
     return 0;
 }
@@ -177,116 +259,191 @@ int Ldpd::stop() {
     _fsms.clear();
     _holds.clear();
     _fds.clear();
+    _tx_pending.clear();
+    _tx_wait.clear();
+    _connects.clear();
+    _hellos.clear();
+
+    _timers.cancel(&_hello_timer);
+    _timers.cancel(&_scan_timer);
+    _timers.cancel(&_housekeeping_timer);
     _transports.clear();
 
+    _ev.close();
+    _clock.close();
+
     return 0;
 }
 
+/**
+ * @brief update the clock and run all timers that are due.
+ */
 void Ldpd::tick() {
-    _now = time(nullptr);
+    _now = Clock::now();
+    _timers.advance(_now);
+}
 
-    if (_now - _last_hello > _hello) {
-        sendHello();
-    }
+void Ldpd::handleHelloTimer(void *self) {
+    Ldpd *ldpd = (Ldpd *) self;
 
-    if (_now - _last_scan > _ifscan) {
-        scanInterfaces();
-    }
+    // todo: check where each peer at which iface & send out only on those iface?
+    ldpd->sendHello();
+    ldpd->_timers.schedule(&ldpd->_hello_timer, ldpd->_now + ldpd->_hello_interval);
+}
 
-    for (std::map<uint64_t, time_t>::iterator hello = _hellos.begin(); hello != _hellos.end(); ) {
-        if (_now - hello->second > getHoldTime(hello->first)) {
-            uint32_t nei_id = (uint32_t) (hello->first >> sizeof(uint16_t));
+void Ldpd::handleScanTimer(void *self) {
+    Ldpd *ldpd = (Ldpd *) self;
 
-            log_info("hello adj with %s removed - hold expired.\n", InetNtop(nei_id).str);
+    ldpd->scanInterfaces();
+    ldpd->_timers.schedule(&ldpd->_scan_timer, ldpd->_now + ldpd->_ifscan);
+}
 
-            if (_holds.count(hello->first)) {
-                _holds[hello->first] = 0xffff;
-            }
+void Ldpd::handleHousekeepingTimer(void *self) {
+    Ldpd *ldpd = (Ldpd *) self;
 
-            hello = _hellos.erase(hello);
-        } else {
-            ++hello;
-        }
+    ldpd->refreshMappings();
+    ldpd->_router->tick();
+    ldpd->reportDispatchStats();
+
+    ldpd->_timers.schedule(&ldpd->_housekeeping_timer, ldpd->_now + LDP_HOUSEKEEPING_INTERVAL);
+}
+
+void Ldpd::handleAdjacencyTimer(void *adjacency) {
+    LdpAdjacency *adj = (LdpAdjacency *) adjacency;
+    Ldpd *ldpd = adj->ldpd;
+    uint64_t key = adj->key;
+
+    uint32_t nei_id = (uint32_t) (key >> sizeof(uint16_t));
+
+    log_info("hello adj with %s removed - hold expired.\n", InetNtop(nei_id).str);
+
+    if (ldpd->_holds.count(key)) {
+        ldpd->_holds[key] = 0xffff;
+        ldpd->updateHelloInterval();
     }
 
-    // todo: check where each peer at which iface & send out only on those iface?
+    // adj (and its timer) is gone after this.
+    ldpd->_hellos.erase(key);
+}
+
+void Ldpd::handleConnectTimer(void *connect) {
+    LdpConnect *conn = (LdpConnect *) connect;
+    Ldpd *ldpd = conn->ldpd;
+    int fd = conn->fd;
+
+    log_warn("connect() on fd %d timed out.\n", fd);
+
+    // conn is gone after this.
+    ldpd->abortConnect(fd, ldpd->_fds[fd]);
+}
+
+/**
+ * @brief recalculate the hello interval: our hello timer, or half the
+ * shortest hold time of the peers if that is shorter. call when _holds
+ * changes.
+ */
+void Ldpd::updateHelloInterval() {
+    uint32_t interval = _hello;
+
     for (std::pair<uint64_t, uint16_t> hold : _holds) {
-        if (_last_hello < _now && _now - _last_hello > hold.second / 2) {
-            sendHello();
+        uint32_t peer_hold = (hold.second == 0 ? LDP_DEF_HELLO_HOLD : hold.second) * 1000;
+
+        if (peer_hold / 2 < interval) {
+            interval = peer_hold / 2;
         }
     }
 
-    for (std::pair<uint64_t, LdpFsm *> fsm : _fsms) {
-        fsm.second->tick();
+    if (interval == 0) {
+        interval = 1;
     }
 
-    refreshMappings();
+    if (interval == _hello_interval) {
+        return;
+    }
 
-    _router->tick();
+    _hello_interval = interval;
+
+    if (_hello_timer.armed()) {
+        _timers.schedule(&_hello_timer, _last_hello + _hello_interval);
+    }
 }
 
 void Ldpd::run() {
-    while(_running) {
-        fd_set fds;
-        struct timeval tv;
-
-        tv.tv_sec = 1;
-        tv.tv_usec = 0;
-
-        FD_ZERO(&fds);
-
-        FD_SET(_tfd, &fds);
-        FD_SET(_ufd, &fds);
+    struct epoll_event events[LDP_EPOLL_BATCH];
 
-        int max_fd = _tfd > _ufd ? _tfd : _ufd;
+    while(_running) {
+        // sleep until the next timer is due.
+        uint64_t next = _timers.nextEvent();
 
-        for (std::pair<int, LdpFsm *> _fd : _fds) {
-            if (_fd.first > max_fd) {
-                max_fd = _fd.first;
-            }
-            FD_SET(_fd.first, &fds);
+        if (next == TIMER_WHEEL_NEVER) {
+            _clock.disarm();
+        } else {
+            _clock.arm(next);
         }
 
-        int ret = select(max_fd + 1, &fds, nullptr, nullptr, &tv);
+        _closed.clear();
+
+        int ret = _ev.wait(events, LDP_EPOLL_BATCH, -1);
         
         tick();
 
+        ++_stats.wakeups;
+
         if (ret < 0) {
-            if (errno == EAGAIN) {
+            if (errno == EINTR) {
                 continue;
             }
 
-            log_error("select(): %s.\n", strerror(errno));
+            log_error("epoll_wait(): %s.\n", strerror(errno));
             continue;
         }
 
-        // timed out
-        if (ret == 0) {
-            continue;
-        }
+        // every ready fd gets serviced on each wakeup. each of the handlers
+        // stops after its budget, so a flood on one socket (hellos, connects)
+        // can't starve the others.
+        for (int i = 0; i < ret && _running; ++i) {
+            int fd = events[i].data.fd;
 
-        if (FD_ISSET(_tfd, &fds)) {
-            handleSession();
-            continue;
-        }
+            if (fd == _tfd) {
+                handleSession();
+                continue;
+            }
 
-        if (FD_ISSET(_ufd, &fds)) {
-            handleHello();
-            continue;
-        }
+            if (fd == _ufd) {
+                handleHello();
+                continue;
+            }
 
-        // FIXME: _fds may change after handleSession call - but don't fix it like this
-        std::vector<int> pending_fds = std::vector<int>();
+            if (fd == _clock.getFd()) {
+                // timers were run by tick() already.
+                _clock.ack();
+                continue;
+            }
 
-        for (std::pair<int, LdpFsm *> _fd : _fds) {
-            if (FD_ISSET(_fd.first, &fds)) {
-                pending_fds.push_back(_fd.first);
+            if (fd == _router->getFd()) {
+                _router->tick();
+                continue;
+            }
+
+            // a session handled earlier in this batch (or a timer) may have
+            // closed this fd, and an accept or connect may have got the same
+            // number back since - the event is not for that socket.
+            if (_closed.count(fd) != 0) {
+                continue;
+            }
+
+            if (events[i].events & EPOLLOUT) {
+                handleSessionWritable(fd);
             }
-        }
 
-        for (int &fd : pending_fds) {
-            handleSession(fd);
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                handleSession(fd);
+            }
         }
+
+        // everything sent while handling this wakeup goes out here, batched
+        // per session.
+        flushSessions();
     }
 }
 
@@ -306,233 +463,347 @@ uint32_t Ldpd::getTransportAddress() const {
     return _transport;
 }
 
+const LdpdDispatchStats& Ldpd::getDispatchStats() const {
+    return _stats;
+}
+
+/**
+ * @brief log the dispatcher counters, if a source ran out of budget since
+ * they were last logged.
+ */
+void Ldpd::reportDispatchStats() {
+    if (_stats.accept_budget_hits == _stats_reported.accept_budget_hits &&
+        _stats.hello_budget_hits == _stats_reported.hello_budget_hits &&
+        _stats.session_budget_hits == _stats_reported.session_budget_hits) {
+        return;
+    }
+
+    log_debug("dispatch: %" PRIu64 " wakeups, budget hits: accept %" PRIu64 ", hello %" PRIu64 ", session %" PRIu64 ".\n", _stats.wakeups, _stats.accept_budget_hits, _stats.hello_budget_hits, _stats.session_budget_hits);
+
+    _stats_reported = _stats;
+}
+
 uint16_t Ldpd::getKeepaliveTime() const {
     return _keep;
 }
 
+/**
+ * @brief get the max pdu length we propose for new sessions.
+ * 
+ * @return uint16_t max pdu length in bytes.
+ */
+uint16_t Ldpd::getMaxPduLength() const {
+    return _max_pdu;
+}
+
 void Ldpd::setTransportAddress(uint32_t address) {
     _transport = address;
+    _hello_dirty = true;
+}
+
+/**
+ * @brief set the hello interval.
+ * 
+ * @param interval interval in ms.
+ */
+void Ldpd::setHelloInterval(uint32_t interval) {
+    _hello = interval == 0 ? 1 : interval;
+    updateHelloInterval();
+}
+
+/**
+ * @brief set the hello hold time. hellos can only carry whole seconds, so
+ * peers are told the hold time rounded up, but our adjacencies time out
+ * after exactly this long.
+ * 
+ * @param hold hold time in ms.
+ */
+void Ldpd::setHelloHoldTime(uint32_t hold) {
+    _hold = hold == 0 ? 1 : hold;
+    _hello_dirty = true;
 }
 
 void Ldpd::setKeepaliveTimer(uint16_t timer) {
     _keep = timer;
 }
 
-ssize_t Ldpd::handleMessage(LdpFsm* from, const LdpMessage *msg) {
+/**
+ * @brief set the max pdu length to propose for new sessions. sessions use the
+ * smaller of this and what the neighbor proposes.
+ * 
+ * @param length max pdu length in bytes. LDP_MAX_PDU_LEN_USE_DEF or less means
+ * the default (LDP_DEF_MAX_PDU_LEN).
+ */
+void Ldpd::setMaxPduLength(uint16_t length) {
+    _max_pdu = length <= LDP_MAX_PDU_LEN_USE_DEF ? LDP_DEF_MAX_PDU_LEN : length;
+}
+
+/**
+ * @brief set the range labels are allocated from. can only be changed
+ * while no label is allocated or reserved (i.e. before start).
+ * 
+ * @param min first label.
+ * @param max last label.
+ * @return int 0 on success, -1 on error.
+ */
+int Ldpd::setLabelRange(uint32_t min, uint32_t max) {
+    if (min < LDP_MIN_LBL || max > LDP_MAX_LBL || max < min) {
+        log_error("bad label range %u - %u, must be in %u - %u.\n", min, max, LDP_MIN_LBL, LDP_MAX_LBL);
+        return -1;
+    }
+
+    if (_labels.available() != (size_t) _labels.getMaxLabel() - _labels.getMinLabel() + 1) {
+        log_error("labels in use, can not change label range.\n");
+        return -1;
+    }
+
+    _labels = LabelAllocator(min, max);
+
+    return 0;
+}
+
+/**
+ * @brief reserve a block of labels for others - ldp will not use them.
+ * 
+ * @param first first label of the block.
+ * @param count number of labels.
+ * @return int 0 on success, -1 on error.
+ */
+int Ldpd::reserveLabels(uint32_t first, uint32_t count) {
+    return _labels.reserve(first, count);
+}
+
+int Ldpd::unreserveLabels(uint32_t first, uint32_t count) {
+    return _labels.unreserve(first, count);
+}
+
+/**
+ * @brief log a parse error, unless too many were logged recently.
+ *
+ * @param from who sent the bad data.
+ * @param what what could not be parsed.
+ * @param err the error.
+ */
+void Ldpd::reportParseError(const char *from, const char *what, const LdpParseError &err) {
+    if (!_parse_log.allow(_now)) {
+        return;
+    }
+
+    log_error("cannot understand %s from %s: %s at offset %zu.\n", what, from, ldpParseErrorText(err.code), err.offset);
+
+    uint32_t suppressed = _parse_log.takeSuppressed();
+
+    if (suppressed > 0) {
+        log_error("%u more parse errors not logged.\n", suppressed);
+    }
+}
+
+ssize_t Ldpd::handleMessage(LdpFsm* from, const LdpMessageView &msg) {
     uint32_t nei_id = from->getNeighborId();
     uint64_t key = LDP_KEY(nei_id, from->getNeighborLabelSpace());
 
     const char *nei_id_str = InetNtop(nei_id).str;
 
-    if (msg->getType() == LDP_MSGTYPE_NOTIFICATION) {
+    if (msg.getType() == LDP_MSGTYPE_NOTIFICATION) {
         log_info("got notification from %s.\n", nei_id_str);
 
-        const LdpRawTlv *status = msg->getTlv(LDP_TLVTYPE_STATUS);
+        LdpTlvView status = msg.getTlv(LDP_TLVTYPE_STATUS);
 
-        if (status == nullptr) {
+        if (!status.valid()) {
             log_error("notification from %s does not have a status tlv.\n", nei_id_str);
-            from->sendNotification(msg->getId(), 0, LDP_SC_MISSING_MSG_PARAM);
+            from->sendNotification(msg.getId(), 0, LDP_SC_MISSING_MSG_PARAM);
             return -1;
         }
 
-        LdpStatusTlvValue *status_val = (LdpStatusTlvValue *) status->getParsedValue();
+        LdpStatusTlvValue status_val = LdpStatusTlvValue();
+        LdpParseError err = LdpParseError();
 
-        if (status_val == nullptr) {
-            log_error("cannot understand the status tlv in notification from %s.\n", nei_id_str);
-            from->sendNotification(msg->getId(), status->getType(), LDP_SC_MALFORMED_TLV_VAL);
+        if (status.parseValue(status_val, &err) < 0) {
+            reportParseError(nei_id_str, "status tlv in notification", err);
+            from->sendNotification(msg.getId(), status.getType(), ldpParseErrorStatus(err.code));
             return -1;
         }
 
-        log_info("status code: %u (%s).\n", status_val->getStatusCode(), status_val->getStatusCodeText());
+        log_info("status code: %u (%s).\n", status_val.getStatusCode(), status_val.getStatusCodeText());
 
-        if (status_val->getStatusCode() == LDP_SC_SHUTDOWN) {
+        if (status_val.getStatusCode() == LDP_SC_SHUTDOWN) {
             // for shutdown msg - we should reply.
             from->sendNotification(0, 0, LDP_SC_SHUTDOWN);
         }
 
-        if (status_val->fatal()) {
+        if (status_val.fatal()) {
             log_error("the notification states fatal error - shutting down session.\n");
-            delete status_val;
             return -1;
         }
 
         // todo
 
-        delete status_val;
+        return msg.size();
     }
 
-    if (msg->getType() == LDP_MSGTYPE_HELLO) {
+    if (msg.getType() == LDP_MSGTYPE_HELLO) {
         log_error("got hello from ldp session with %s (the tcp one), what?\n", nei_id_str);
-        from->sendNotification(msg->getId(), 0, LDP_SC_SHUTDOWN);
+        from->sendNotification(msg.getId(), 0, LDP_SC_SHUTDOWN);
         return -1;
     }
 
-    if (msg->getType() == LDP_MSGTYPE_INITIALIZE) {
+    if (msg.getType() == LDP_MSGTYPE_INITIALIZE) {
         log_error("got init from ldp session with %s, but session is already operational.\n", nei_id_str);
-        from->sendNotification(msg->getId(), 0, LDP_SC_SHUTDOWN);
+        from->sendNotification(msg.getId(), 0, LDP_SC_SHUTDOWN);
         return -1;
     }
 
-    if (msg->getType() == LDP_MSGTYPE_KEEPALIVE) {
+    if (msg.getType() == LDP_MSGTYPE_KEEPALIVE) {
         log_warn("got keepalive from session with %s - this should have been handlded by the fsm.\n", nei_id_str);
-        return msg->length();
+        return msg.size();
     }
 
-    if (msg->getType() == LDP_MSGTYPE_ADDRESS) {
+    if (msg.getType() == LDP_MSGTYPE_ADDRESS) {
         log_debug("got address list from ldp session with %s.\n", nei_id_str);
 
-        const LdpRawTlv *addrs = msg->getTlv(LDP_TLVTYPE_ADDRESS_LIST);
+        LdpTlvView addrs = msg.getTlv(LDP_TLVTYPE_ADDRESS_LIST);
 
-        if (addrs == nullptr) {
+        if (!addrs.valid()) {
             log_error("address mseesge from %s does not have a address-list tlv.\n", nei_id_str);
-            from->sendNotification(msg->getId(), 0, LDP_SC_MISSING_MSG_PARAM);
+            from->sendNotification(msg.getId(), 0, LDP_SC_MISSING_MSG_PARAM);
             return -1;
         }
 
-        LdpAddressTlvValue *addrs_val = (LdpAddressTlvValue *) addrs->getParsedValue();
+        LdpAddressTlvValue addrs_val = LdpAddressTlvValue();
+        LdpParseError err = LdpParseError();
 
-        if (addrs_val == nullptr) {
-            log_error("cannot understand the address-list tlv in address message from %s.\n", nei_id_str);
-            from->sendNotification(msg->getId(), addrs->getType(), LDP_SC_MALFORMED_TLV_VAL);
+        if (addrs.parseValue(addrs_val, &err) < 0) {
+            reportParseError(nei_id_str, "address-list tlv in address message", err);
+            from->sendNotification(msg.getId(), addrs.getType(), ldpParseErrorStatus(err.code));
             return -1;
         }
 
-        _addresses[key] = std::vector<uint32_t>(addrs_val->getAddresses());
+        _addresses[key] = std::vector<uint32_t>(addrs_val.getAddresses());
 
         for (uint32_t &addr : _addresses[key]) {
             log_debug("address: %s.\n", InetNtop(addr).str);
         }
 
-        delete addrs_val;
+        // bindings that came in before the addresses may be installable now.
+        retryUnresolved();
 
-        return msg->length();
+        return msg.size();
     }
 
-    if (msg->getType() == LDP_MSGTYPE_ADDRESS_WITHDRAW) { // todo
+    if (msg.getType() == LDP_MSGTYPE_ADDRESS_WITHDRAW) { // todo
         log_debug("got address withdraw from ldp session with %s.\n", nei_id_str);
 
-        return msg->length();
+        return msg.size();
     }
 
-    if (msg->getType() == LDP_MSGTYPE_LABEL_MAPPING || msg->getType() == LDP_MSGTYPE_LABEL_WITHDRAW) {
-        const char *msgname = msg->getType() == LDP_MSGTYPE_LABEL_MAPPING ? "lbl mapping" : "lbl withdraw";
+    if (msg.getType() == LDP_MSGTYPE_LABEL_MAPPING || msg.getType() == LDP_MSGTYPE_LABEL_WITHDRAW) {
+        const char *msgname = msg.getType() == LDP_MSGTYPE_LABEL_MAPPING ? "lbl mapping" : "lbl withdraw";
 
-        const LdpRawTlv *fec = msg->getTlv(LDP_TLVTYPE_FEC);
+        LdpTlvView fec = msg.getTlv(LDP_TLVTYPE_FEC);
 
-        if (fec == nullptr) {
+        if (!fec.valid()) {
             log_error("%s mseesge from %s does not have a fec tlv.\n", msgname, nei_id_str);
-            from->sendNotification(msg->getId(), 0, LDP_SC_MISSING_MSG_PARAM);
-            return -1;
-        }
-
-        LdpFecTlvValue *fec_val = (LdpFecTlvValue *) fec->getParsedValue();
-
-        if (fec_val == nullptr) {
-            log_error("cannot understand the fec tlv in %s message from %s.\n", msgname, nei_id_str);
-            from->sendNotification(msg->getId(), fec->getType(), LDP_SC_MALFORMED_TLV_VAL);
+            from->sendNotification(msg.getId(), 0, LDP_SC_MISSING_MSG_PARAM);
             return -1;
         }
 
-        const LdpRawTlv *lbl = msg->getTlv(LDP_TLVTYPE_GENERIC_LABEL); // todo: other label?
+        LdpTlvView lbl = msg.getTlv(LDP_TLVTYPE_GENERIC_LABEL); // todo: other label?
 
-        if (lbl == nullptr) {
+        if (!lbl.valid()) {
             log_error("%s mseesge from %s does not have a label tlv.\n", msgname, nei_id_str);
-            from->sendNotification(msg->getId(), 0, LDP_SC_MISSING_MSG_PARAM);
+            from->sendNotification(msg.getId(), 0, LDP_SC_MISSING_MSG_PARAM);
             return -1;
         }
 
-        LdpGenericLabelTlvValue *lbl_val = (LdpGenericLabelTlvValue *) lbl->getParsedValue();
+        LdpGenericLabelTlvValue lbl_val = LdpGenericLabelTlvValue();
+        LdpParseError err = LdpParseError();
 
-        if (lbl_val == nullptr) {
-            log_error("cannot understand the label tlv in %s message from %s.\n", msgname, nei_id_str);
-            from->sendNotification(msg->getId(), lbl->getType(), LDP_SC_MALFORMED_TLV_VAL);
+        if (lbl.parseValue(lbl_val, &err) < 0) {
+            reportParseError(nei_id_str, "label tlv", err);
+            from->sendNotification(msg.getId(), lbl.getType(), ldpParseErrorStatus(err.code));
             return -1;
         }
 
-        if (_mappings.count(key) == 0) {
-            _mappings[key] = std::vector<LdpLabelMapping>();
-        }
-
-        for (const LdpFecElement *el : fec_val->getElements()) {
-            LdpLabelMapping mapping = LdpLabelMapping();
-            mapping.remote = true;
-            mapping.out_label = lbl_val->getLabel();
-
-            if (el->getType() == 0x01) {
-                mapping.fec.prefix = 0;
-                mapping.fec.len = 0;
-                
-                log_debug("%s: %s: prefix: 0.0.0.0/0 lbl %u\n", nei_id_str, msgname, lbl_val->getLabel());
-            }
+        // fec elements are read straight out of the receive buffer - a big
+        // mapping burst does not allocate per element.
+        LdpFecView elements = LdpFecView(fec);
 
-            if (el->getType() == 0x02) {
-                const LdpFecPrefixElement *e = (LdpFecPrefixElement *) el;
+        uint8_t el_type;
+        int rslt;
 
-                mapping.fec.len = e->getPrefixLength();
-                mapping.fec.prefix = e->getPrefix();
-
-                log_debug("%s: %s: prefix: %s/%d lbl %u.\n", nei_id_str, msgname, InetNtop(mapping.fec.prefix).str, mapping.fec.len, lbl_val->getLabel());
-            }
-
-            if (msg->getType() == LDP_MSGTYPE_LABEL_MAPPING) {
-                _mappings[key].push_back(mapping);
+        LdpLabelMapping mapping = LdpLabelMapping();
+        mapping.remote = true;
+        mapping.out_label = lbl_val.getLabel();
+
+        while ((rslt = elements.next(el_type, mapping.fec.prefix, mapping.fec.len, &err)) > 0) {
+            log_debug("%s: %s: prefix: %s/%d lbl %u.\n", nei_id_str, msgname, InetNtop(mapping.fec.prefix).str, mapping.fec.len, lbl_val.getLabel());
+
+            if (msg.getType() == LDP_MSGTYPE_LABEL_MAPPING) {
+                LdpLabelMapping *binding = _mappings.find(key, mapping.fec);
+
+                if (binding == nullptr) {
+                    _mappings.update(key, mapping);
+                    markDirty(mapping.fec);
+                } else if (binding->out_label != mapping.out_label) {
+                    // label changed - take the routes w/ the old one down,
+                    // refresh puts them back w/ the new one. in label stays.
+                    uninstallMapping(key, *binding);
+                    binding->out_label = mapping.out_label;
+                    markDirty(mapping.fec);
+                }
             }
 
-            if (msg->getType() == LDP_MSGTYPE_LABEL_WITHDRAW) {
+            if (msg.getType() == LDP_MSGTYPE_LABEL_WITHDRAW) {
                 _pending_delete_mappings[key].insert(mapping);
             }
+        }
 
+        if (rslt < 0) {
+            reportParseError(nei_id_str, "fec tlv", err);
+            from->sendNotification(msg.getId(), fec.getType(), ldpParseErrorStatus(err.code));
+            return -1;
         }
 
-        if (msg->getType() == LDP_MSGTYPE_LABEL_WITHDRAW) { 
+        if (msg.getType() == LDP_MSGTYPE_LABEL_WITHDRAW) { 
             // this sends release even if the given lbl is never mapped - but whatever.
 
-            LdpPdu pdu = LdpPdu();
-
-            LdpMessage *release_msg = new LdpMessage();
+            LdpPduWriter writer = LdpPduWriter();
 
-            release_msg->setType(LDP_MSGTYPE_LABEL_RELEASE);
-            pdu.addMessage(release_msg);
-
-            LdpRawTlv *fec = new LdpRawTlv();
-            fec->setValue(fec_val);
-
-            release_msg->addTlv(fec);
-
-            LdpRawTlv *lbl = new LdpRawTlv();
-            lbl->setValue(lbl_val);
+            if (from->beginPdu(writer) < 0) {
+                return -1;
+            }
 
-            release_msg->addTlv(lbl);
-            release_msg->recalculateLength();
+            // fec and label tlvs are sent back as they came in.
+            writer.beginMessage(LDP_MSGTYPE_LABEL_RELEASE, getNextMessageId());
+            writer.addRawTlv(fec.data(), fec.size());
+            writer.addRawTlv(lbl.data(), lbl.size());
+            writer.endMessage();
 
-            from->send(pdu);
+            from->send(writer);
         }
-        
-        delete lbl_val;
-        delete fec_val;
 
-        return msg->length();
+        return msg.size();
     }
 
-    if (msg->getType() == LDP_MSGTYPE_LABEL_REQUEST) { // todo
+    if (msg.getType() == LDP_MSGTYPE_LABEL_REQUEST) { // todo
         log_debug("got label request from ldp session with %s.\n", nei_id_str);
 
-        return msg->length();
+        return msg.size();
     }
 
-    if (msg->getType() == LDP_MSGTYPE_LABEL_RELEASE) { // todo
+    if (msg.getType() == LDP_MSGTYPE_LABEL_RELEASE) { // todo
         log_debug("got label release from ldp session with %s.\n", nei_id_str);
 
-        return msg->length();
+        return msg.size();
     }
 
-    if (msg->getType() == LDP_MSGTYPE_LABEL_ABORT) { // todo
+    if (msg.getType() == LDP_MSGTYPE_LABEL_ABORT) { // todo
         log_debug("got label abort from ldp session with %s.\n", nei_id_str);
 
-        return msg->length();
+        return msg.size();
     }
 
-    from->sendNotification(msg->getId(), 0, LDP_SC_UNKNOWN_MSG_TYPE);
+    from->sendNotification(msg.getId(), 0, LDP_SC_UNKNOWN_MSG_TYPE);
     return -1;
 }
 
@@ -542,17 +813,23 @@ void Ldpd::shutdownSession(LdpFsm* of, int32_t code, uint32_t msgid, uint16_t ms
     for (std::pair<int, LdpFsm *> _fd : _fds) {
         if (_fd.second == of) {
             log_info("closing fd %d.\n", _fd.first);
-            if (code > 0) {
+            if (code > 0 && of->getState() != LdpSessionState::Connecting) {
                 of->sendNotification(msgid, msgtype, (uint32_t) code);
             }          
+
+            // best effort - whatever the socket does not take now is lost.
+            of->getSendQueue().flush(_fd.first);
+            _tx_pending.erase(_fd.first);
+            _tx_wait.erase(_fd.first);
             
+            _ev.remove(_fd.first);
             close(_fd.first);
+            _closed.insert(_fd.first);
         }
     }
 
     _exported_mappings.erase(key);
-
-
+    _export_queues.erase(key);
 }
 
 void Ldpd::removeSession(LdpFsm* of) {
@@ -583,9 +860,11 @@ void Ldpd::removeSession(LdpFsm* of) {
 
     _addresses.erase(key);
 
-    if (_mappings.count(key) != 0) {
-        for (const LdpLabelMapping &mapping : _mappings[key]) {
-            _pending_delete_mappings[key].insert(mapping);
+    MappingDb::Bindings *bindings = _mappings.getBindings(key);
+
+    if (bindings != nullptr) {
+        for (const std::pair<const Prefix, LdpLabelMapping> &binding : *bindings) {
+            _pending_delete_mappings[key].insert(binding.second);
         }
     }
 
@@ -596,67 +875,95 @@ void Ldpd::removeSession(LdpFsm* of) {
 
 void Ldpd::handleHello() {
     // TODO: targeted hellos?
-    uint8_t buffer[8192];
-    uint8_t control[128];
+    struct mmsghdr *msgs = _hello_batch->msgs;
 
-    struct msghdr message;
-    struct sockaddr_in remote;
-    struct iovec iov;
+    for (int received = 0; received < LDP_HELLO_BUDGET; ) {
+        unsigned int vlen = LDP_HELLO_BUDGET - received;
 
-    memset(&message, 0, sizeof(message));
-    memset(&remote, 0, sizeof(remote));
-    memset(&iov, 0, sizeof(iov));
+        if (vlen > LDP_HELLO_BATCH) {
+            vlen = LDP_HELLO_BATCH;
+        }
 
-    iov.iov_base = buffer;
-    iov.iov_len = sizeof(buffer);
+        // the kernel overwrites these w/ the actual lengths.
+        for (unsigned int i = 0; i < vlen; ++i) {
+            msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            msgs[i].msg_hdr.msg_controllen = LDP_HELLO_CONTROL_SIZE;
+            msgs[i].msg_hdr.msg_flags = 0;
+        }
 
-    message.msg_name = &remote;
-    message.msg_namelen = sizeof(remote);
-    message.msg_iov = &iov;
-    message.msg_iovlen = 1;
-    message.msg_control = control;
-    message.msg_controllen = sizeof(control);
+        int count = recvmmsg(_ufd, msgs, vlen, 0, nullptr);
 
-    ssize_t len = recvmsg(_ufd, &message, 0);
+        if (count < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                log_warn("recvmmsg(): %s.\n", strerror(errno));
+            }
 
-    if (len < 0) {
-        log_warn("recvmsg(): %s.\n", strerror(errno));
-        return;
-    }
+            return;
+        }
 
-    if (len == 0) {
-        log_warn("recvmsg(): got eof.\n");
-        return;
-    }
+        for (int i = 0; i < count; ++i) {
+            struct msghdr *message = &msgs[i].msg_hdr;
+            size_t len = msgs[i].msg_len;
 
-    struct in_pktinfo *pktinfo = nullptr;
+            if (len == 0) {
+                log_warn("recvmmsg(): got empty datagram.\n");
+                continue;
+            }
 
-    for(struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg)) {
-        if (cmsg->cmsg_type != IP_PKTINFO || cmsg->cmsg_level != IPPROTO_IP) {
-            continue;
+            if (message->msg_flags & MSG_TRUNC) {
+                log_warn("recvmmsg(): hello larger than %u bytes, dropped.\n", LDP_HELLO_BUFFER_SIZE);
+                continue;
+            }
+
+            struct in_pktinfo *pktinfo = nullptr;
+
+            for(struct cmsghdr *cmsg = CMSG_FIRSTHDR(message); cmsg != nullptr; cmsg = CMSG_NXTHDR(message, cmsg)) {
+                if (cmsg->cmsg_type != IP_PKTINFO || cmsg->cmsg_level != IPPROTO_IP) {
+                    continue;
+                }
+
+                pktinfo = (struct in_pktinfo *) CMSG_DATA(cmsg);
+                break;
+            }
+
+            if (pktinfo == nullptr) {
+                log_error("recvmmsg() result does not have a ip_pktinfo message.\n");
+                continue;
+            }
+
+            processHello(_hello_batch->buffers[i], len, _hello_batch->remotes[i], pktinfo->ipi_ifindex);
+            _pdu_arena.reset();
         }
 
-        pktinfo = (struct in_pktinfo *) CMSG_DATA(cmsg);
-        break;
+        received += count;
+
+        // socket drained.
+        if ((unsigned int) count < vlen) {
+            return;
+        }
     }
 
-    if (pktinfo == nullptr) {
-        log_error("recvmsg() result does not have a ip_pktinfo message.\n");
+    // the last batch may have been full and still emptied the socket.
+    if (!inputPending(_ufd)) {
         return;
     }
 
+    ++_stats.hello_budget_hits;
+}
+
+void Ldpd::processHello(const uint8_t *buffer, size_t len, const struct sockaddr_in &remote, int ifindex) {
     bool ldp_enabled = false;
 
     for (const std::string &ifname : _ldp_ifaces) {
         for (const Interface &iface : _ifaces) {
-            if (iface.ifname == ifname && pktinfo->ipi_ifindex == iface.index) {
+            if (iface.ifname == ifname && ifindex == iface.index) {
                 ldp_enabled = true;
             }
         }
     }
 
     if (!ldp_enabled) {
-        log_debug("got hello on interface %d, but ldp is not enabled on it.\n", pktinfo->ipi_ifindex);
+        log_debug("got hello on interface %d, but ldp is not enabled on it.\n", ifindex);
         return;
     }
 
@@ -669,13 +976,23 @@ void Ldpd::handleHello() {
         }
     }
 
-    LdpPdu pdu = LdpPdu();
+    const char* remote_addr_str = InetNtop(remote.sin_addr.s_addr).str;
 
-    ssize_t res = pdu.parse(buffer, len);
+    // anyone on the link can send us anything: check the pdu w/ the view
+    // first, so garbage is dropped before anything is allocated for it. the
+    // pdu is then built from the view w/o checking it again.
+    LdpPduView view = LdpPduView();
+    LdpParseError err = LdpParseError();
 
-    const char* remote_addr_str = InetNtop(remote.sin_addr.s_addr).str;
+    if (view.parse(buffer, len, &err) < 0) {
+        reportParseError(remote_addr_str, "hello pdu", err);
+        return;
+    }
+
+    // arena is reset by handleHello() once we return.
+    LdpPdu pdu = LdpPdu(&_pdu_arena);
 
-    if (res < 0) {
+    if (pdu.parse(view) < 0) {
         log_info("invalid pdu from %s:%u (cannot understand).\n", remote_addr_str, ntohs(remote.sin_port));
         return;
     }
@@ -704,26 +1021,36 @@ void Ldpd::handleHello() {
         return;
     }
 
-    LdpCommonHelloParamsTlvValue *params_val = (LdpCommonHelloParamsTlvValue *) params->getParsedValue();
+    const LdpCommonHelloParamsTlvValue *params_val = params->getValue<LdpCommonHelloParamsTlvValue>();
 
     if (params_val == nullptr) {
         log_info("invalid hello msg from %s:%u (cannot understand hello params tlv).\n", remote_addr_str, ntohs(remote.sin_port));
         return;
     }
 
-    _holds[key] = params_val->getHoldTime();
+    if (_holds.count(key) == 0 || _holds[key] != params_val->getHoldTime()) {
+        _holds[key] = params_val->getHoldTime();
+        updateHelloInterval();
+    }
 
     // TODO: targeted / req_targeted, gtsm
 
-    delete params_val;
-
     const char *nei_id_str = InetNtop(nei_id).str;
 
-    if (!_hellos.count(key) || _now - _hellos[key] > _hold) {
+    if (_hellos.count(key) == 0) {
         log_info("got a new hello from %s:%u, id: %s:%u.\n", remote_addr_str, ntohs(remote.sin_port), nei_id_str, nei_ls);
+
+        LdpAdjacency &adj = _hellos[key];
+
+        adj.ldpd = this;
+        adj.key = key;
+        adj.hold.setHandler(Ldpd::handleAdjacencyTimer, &adj);
     } 
 
-    _hellos[key] = _now;
+    LdpAdjacency &adj = _hellos[key];
+
+    adj.last_hello = _now;
+    _timers.schedule(&adj.hold, _now + getHoldTime(key) + 1);
 
     const LdpRawTlv *ta_tlv = hello->getTlv(LDP_TLVTYPE_IPV4_TRANSPORT);
 
@@ -732,7 +1059,7 @@ void Ldpd::handleHello() {
         return;
     }
 
-    const LdpIpv4TransportAddressTlvValue *ta_tlv_val = (const LdpIpv4TransportAddressTlvValue *) ta_tlv->getParsedValue();
+    const LdpIpv4TransportAddressTlvValue *ta_tlv_val = ta_tlv->getValue<LdpIpv4TransportAddressTlvValue>();
 
     if (ta_tlv_val == nullptr) {
         log_warn("%s:%u included a transport-address tlv in hello, but we don't understand it.\n", nei_id_str, nei_ls);
@@ -741,8 +1068,6 @@ void Ldpd::handleHello() {
 
     uint32_t ta = ta_tlv_val->getAddress();
 
-    delete ta_tlv_val;
-
     if (_transports.count(key) == 0 || _transports[key] != ta) {
         log_info("learned transport address for %s:%u - %s.\n", nei_id_str, nei_ls, InetNtop(ta).str);
         _transports[key] = ta;
@@ -761,135 +1086,239 @@ void Ldpd::handleHello() {
 }
 
 void Ldpd::handleSession() {
+    for (int budget = 0; budget < LDP_ACCEPT_BUDGET; ++budget) {
+        if (!acceptSession()) {
+            return;
+        }
+    }
+
+    // the budget may have taken exactly what was in the backlog.
+    if (!inputPending(_tfd)) {
+        return;
+    }
+
+    ++_stats.accept_budget_hits;
+}
+
+/**
+ * @brief accept one pending connection on the listening socket.
+ * 
+ * @return true if a connection was taken off the backlog (whether or not it
+ * ended up as a session).
+ * @return false if there is nothing more to accept for now.
+ */
+bool Ldpd::acceptSession() {
     struct sockaddr_in remote;
     memset(&remote, 0, sizeof(remote));
 
     socklen_t addrlen = sizeof(remote);
 
-    int fd = accept(_tfd, (struct sockaddr *) &remote, &addrlen);
+    int fd = accept4(_tfd, (struct sockaddr *) &remote, &addrlen, SOCK_NONBLOCK);
 
     if (fd < 0) {
-        log_warn("accept(): %s.\n", strerror(errno));
-        return;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            log_warn("accept(): %s.\n", strerror(errno));
+        }
+
+        return false;
     }
 
     if (remote.sin_family != AF_INET) {
         log_warn("accept(): got non-ipv4?\n");
-        return;
+        close(fd);
+        return true;
     }
 
     log_info("new tcp connection from %s:%u.\n", InetNtop(remote.sin_addr.s_addr).str, ntohs(remote.sin_port));
 
-    uint8_t buffer[8192];
-    ssize_t len = read(fd, buffer, sizeof(buffer));
-
-    // FIXME: make sure it has atleast one full pdu?
-
-    if (len < 0) {
-        log_warn("read(): %s.\n", strerror(errno));
-        return;
-    }
-
-    if (len == 0) {
-        log_warn("read(): got eof.\n");
-        return;
-    }
-
+    // the init message is picked up by handleSession(fd) once it arrives;
+    // the session gets registered after that (see registerSession()).
     LdpFsm *session = new LdpFsm(this);
+    session->setFd(fd);
     _fds[fd] = session;
-    
-    int offset = 0;
-
-    while (len > 0) {
-        ssize_t ret = session->receive(buffer + offset, len);
-
-        if (ret < 0 || session->getState() < LdpSessionState::OpenReceived) {
-            // if recv failed, or state changed, fsm has sent out notification. we don't need to send again.
-            shutdownSession(session, -1);
-            removeSession(session);
-            return;
-        }
+    _ev.add(fd, EPOLLIN);
 
-        offset += ret;
-        len -= ret;
-    }
+    return true;
+}
 
+/**
+ * @brief register a passively opened session once its init message has been
+ * processed and we know who the neighbor is.
+ * 
+ * @param fd session fd.
+ * @param session the session.
+ * @return true if the session is (now) registered.
+ * @return false if the session was rejected and deleted.
+ */
+bool Ldpd::registerSession(int fd, LdpFsm *session) {
     uint32_t nei_id = session->getNeighborId();
     uint16_t nei_space = session->getNeighborLabelSpace();
 
     log_info("neigh lsr-id: %s:%u.\n", InetNtop(nei_id).str, nei_space);
 
-    uint32_t key = LDP_KEY(nei_id, nei_space);
+    uint64_t key = LDP_KEY(nei_id, nei_space);
 
-    if (_hellos.count(key) == 0 || _now - _hellos[key] > getHoldTime(key)) {
+    if (_hellos.count(key) == 0 || _now - _hellos[key].last_hello > getHoldTime(key)) {
         log_warn("no hello from them or hold expired. rejecting.\n");
 
-        shutdownSession(session, LDP_SC_SESSION_REJ_NOHELLO);
-        removeSession(session);
-        return;
+        rejectSession(fd, session, LDP_SC_SESSION_REJ_NOHELLO);
+        return false;
     }
     
     if (_fsms.count(key) != 0) {
         log_warn("a session with a router w/ same lrs-id exists? rejecting.\n");
-        close(fd);
-        return;
+        rejectSession(fd, session, LDP_SC_SHUTDOWN);
+        return false;
     }
 
     _fsms[key] = session;
 
     log_info("looks good, registering them.\n");
 
+    return true;
 }
 
-void Ldpd::handleSession(int fd) {
-    uint8_t buffer[8192];
-    ssize_t len = read(fd, buffer, sizeof(buffer));
+/**
+ * @brief close and delete a session that never got registered. unlike
+ * shutdownSession()/removeSession(), this does not touch any state keyed by
+ * the neighbor's lsr-id, which may belong to another session.
+ * 
+ * @param fd session fd.
+ * @param session the session.
+ * @param code status code to send, or negative to send nothing.
+ */
+void Ldpd::rejectSession(int fd, LdpFsm *session, int32_t code) {
+    if (code > 0) {
+        session->sendNotification(0, 0, (uint32_t) code);
+    }
+
+    session->getSendQueue().flush(fd);
+    _tx_pending.erase(fd);
+    _tx_wait.erase(fd);
+
+    _ev.remove(fd);
+    close(fd);
+    _closed.insert(fd);
+
+    _fds.erase(fd);
+    delete session;
+}
 
+void Ldpd::handleSession(int fd) {
     if (_fds.count(fd) == 0) {
         return;
     }
 
     LdpFsm *session = _fds[fd];
 
-    // FIXME: make sure it has atleast one full pdu?
-
-    if (len < 0) {
-        log_warn("read(): %s.\n", strerror(errno));
+    if (session->getState() == LdpSessionState::Connecting) {
+        completeConnect(fd, session);
         return;
     }
 
-    if (len == 0) {
-        log_error("read(): got eof - removing.\n");
-        removeSession(session);
-        return;
-    }
+    LdpPduReassembler &rx = session->getReceiveBuffer();
 
-    int offset = 0;
-    while (len > 0) {
-        // FIXME: buffer read from fd may have .5 or 1.5 pkt - need to save partial pkt.
-        ssize_t ret = session->receive(buffer + offset, len);
+    for (int budget = 0; budget < LDP_SESSION_READ_BUDGET; ++budget) {
+        size_t avail;
+        uint8_t *buffer = rx.prepare(avail);
 
-        if (ret < 0 || session->getState() == LdpSessionState::Invalid) {
-            shutdownSession(session);
+        if (buffer == nullptr) {
+            if (session->getState() == LdpSessionState::Initialized) {
+                rejectSession(fd, session, LDP_SC_INTERNAL_ERROR);
+                return;
+            }
+
+            shutdownSession(session, LDP_SC_INTERNAL_ERROR);
             removeSession(session);
             return;
         }
 
-        offset += ret;
-        len -= ret;
-    }
-}
+        ssize_t len = recv(fd, buffer, avail, MSG_DONTWAIT);
 
-void Ldpd::sendHello() {
-    struct sockaddr_in remote;
-    memset(&remote, 0, sizeof(remote));
+        if (len < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                log_warn("read(): %s.\n", strerror(errno));
+            }
 
-    remote.sin_family = AF_INET;
-    remote.sin_addr.s_addr = htonl(INADDR_ALLRTRS_GROUP);
-    remote.sin_port = htons(LDP_PORT);
+            return;
+        }
 
-    socklen_t addrlen = sizeof(remote);
+        if (len == 0) {
+            log_error("read(): got eof - removing.\n");
+
+            if (session->getState() == LdpSessionState::Initialized) {
+                rejectSession(fd, session, -1);
+                return;
+            }
+
+            shutdownSession(session, -1);
+            removeSession(session);
+            return;
+        }
+
+        rx.commit((size_t) len);
+
+        const uint8_t *pdu;
+        size_t pdu_len;
+        int rslt;
+
+        while ((rslt = rx.next(pdu, pdu_len)) == LDP_REASM_PDU) {
+            LdpSessionState prev_state = session->getState();
+
+            ssize_t ret = session->receive(pdu, pdu_len);
+
+            if (ret < 0 || session->getState() == LdpSessionState::Invalid) {
+                if (prev_state == LdpSessionState::Initialized) {
+                    // fsm has sent out notification. we don't need to send again.
+                    rejectSession(fd, session, -1);
+                    return;
+                }
+
+                shutdownSession(session);
+                removeSession(session);
+                return;
+            }
 
+            if (prev_state == LdpSessionState::Initialized && session->getState() != prev_state) {
+                if (!registerSession(fd, session)) {
+                    return;
+                }
+            }
+        }
+
+        if (rslt == LDP_REASM_BAD_LENGTH) {
+            log_error("bad pdu length from session fd %d - removing.\n", fd);
+
+            if (session->getState() == LdpSessionState::Initialized) {
+                rejectSession(fd, session, LDP_SC_BAD_PDU_LEN);
+                return;
+            }
+
+            shutdownSession(session, LDP_SC_BAD_PDU_LEN);
+            removeSession(session);
+            return;
+        }
+
+        // socket drained.
+        if ((size_t) len < avail) {
+            return;
+        }
+    }
+
+    // the last read may have filled the buffer and still emptied the socket.
+    if (!inputPending(fd)) {
+        return;
+    }
+
+    ++_stats.session_budget_hits;
+}
+
+/**
+ * @brief encode the hello pdu into _hello_pdu.
+ * 
+ * @return int status. 0 on success, 1 on error.
+ */
+int Ldpd::encodeHello() {
     LdpPdu pdu = LdpPdu();
     
     pdu.setRouterId(_id);
@@ -899,7 +1328,8 @@ void Ldpd::sendHello() {
 
     LdpRawTlv *common = new LdpRawTlv();
     LdpCommonHelloParamsTlvValue common_val = LdpCommonHelloParamsTlvValue();
-    common_val.setHoldTime(_hold);
+    uint32_t hold_sec = (_hold + 999) / 1000;
+    common_val.setHoldTime(hold_sec > 0xffff ? 0xffff : (uint16_t) hold_sec);
     common->setValue(&common_val);
 
     LdpRawTlv *ta = new LdpRawTlv();
@@ -910,8 +1340,7 @@ void Ldpd::sendHello() {
     LdpRawTlv *cs = new LdpRawTlv();
     LdpConfigSeqNumTlvValue cs_vl = LdpConfigSeqNumTlvValue();
 
-    // FIXME: track local config change.
-    cs_vl.setSeq(114514);
+    cs_vl.setSeq(_config_seq);
     cs->setValue(&cs_vl);
 
     hello->setType(LDP_MSGTYPE_HELLO);
@@ -920,7 +1349,8 @@ void Ldpd::sendHello() {
     hello->addTlv(ta);
     hello->addTlv(cs);
 
-    hello->setId(getNextMessageId());
+    // patched in for each send.
+    hello->setId(0);
     hello->recalculateLength();
 
     pdu.addMessage(hello);
@@ -928,65 +1358,208 @@ void Ldpd::sendHello() {
 
     size_t len = pdu.length();
     
-    uint8_t *buffer = (uint8_t *) malloc(len);
+    uint8_t *buffer = (uint8_t *) realloc(_hello_pdu, len);
+
+    if (buffer == nullptr) {
+        log_error("realloc(): can not allocate hello pdu.\n");
+        return 1;
+    }
 
-    pdu.write(buffer, len);
+    _hello_pdu = buffer;
 
-    for (const std::string &ifname : _ldp_ifaces) {
-        uint32_t outaddr = 0;
+    if (pdu.write(_hello_pdu, len) < 0) {
+        log_error("failed to write hello pdu.\n");
+        _hello_len = 0;
+        return 1;
+    }
 
-        for (const Interface &iface : _ifaces) {
-            if (iface.ifname == ifname && iface.addresses.size() > 0) {
-                outaddr = iface.addresses[0].address.prefix;
-            }
+    _hello_len = len;
+    _hello_dirty = false;
+
+    return 0;
+}
+
+/**
+ * @brief send a hello out of every ldp interface. the encoded hello is
+ * cached; one sendmmsg() covers up to LDP_HELLO_BATCH interfaces, w/ the
+ * outgoing interface and source address of each given in IP_PKTINFO.
+ */
+void Ldpd::sendHello() {
+    if (_hello_dirty && encodeHello() != 0) {
+        return;
+    }
+
+    _last_hello = _now;
+
+    if (_hello_targets.size() == 0) {
+        return;
+    }
+
+    uint32_t msgid = htonl(getNextMessageId());
+    memcpy(_hello_pdu + LDP_HELLO_MSGID_OFFSET, &msgid, sizeof(msgid));
+
+    struct sockaddr_in remote;
+    memset(&remote, 0, sizeof(remote));
+
+    remote.sin_family = AF_INET;
+    remote.sin_addr.s_addr = htonl(INADDR_ALLRTRS_GROUP);
+    remote.sin_port = htons(LDP_PORT);
+
+    struct iovec iov;
+    iov.iov_base = _hello_pdu;
+    iov.iov_len = _hello_len;
+
+    struct mmsghdr msgs[LDP_HELLO_BATCH];
+    uint8_t control[LDP_HELLO_BATCH][CMSG_SPACE(sizeof(struct in_pktinfo))];
+
+    for (size_t done = 0; done < _hello_targets.size(); ) {
+        unsigned int vlen = 0;
+
+        memset(msgs, 0, sizeof(msgs));
+        memset(control, 0, sizeof(control));
+
+        for (; vlen < LDP_HELLO_BATCH && done + vlen < _hello_targets.size(); ++vlen) {
+            struct msghdr *message = &msgs[vlen].msg_hdr;
+
+            message->msg_name = &remote;
+            message->msg_namelen = sizeof(remote);
+            message->msg_iov = &iov;
+            message->msg_iovlen = 1;
+            message->msg_control = control[vlen];
+            message->msg_controllen = sizeof(control[vlen]);
+
+            struct cmsghdr *cmsg = CMSG_FIRSTHDR(message);
+
+            cmsg->cmsg_level = IPPROTO_IP;
+            cmsg->cmsg_type = IP_PKTINFO;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(struct in_pktinfo));
+
+            memcpy(CMSG_DATA(cmsg), &_hello_targets[done + vlen], sizeof(struct in_pktinfo));
         }
 
-        if (outaddr == 0) {
-            log_error("no interface with name %s, or no valid ip address on it.\n", ifname.c_str());
+        int sent = sendmmsg(_ufd, msgs, vlen, 0);
+
+        if (sent < 0) {
+            log_error("sendmmsg(): %s.\n", strerror(errno));
+
+            // skip the one that failed, carry on w/ the rest.
+            ++done;
             continue;
         }
 
-        if (setsockopt(_ufd, IPPROTO_IP, IP_MULTICAST_IF, &outaddr, sizeof(outaddr)) < 0) {
-            log_error("setsockopt(): %s.\n", strerror(errno));
+        if (sent == 0) {
+            ++done;
             continue;
         }
 
-        ssize_t res = sendto(_ufd, buffer, len, 0, (struct sockaddr *) &remote, addrlen);
-        if (res < 0) {
-            log_error("sendto(): %s.\n", strerror(errno));
-        }
+        done += sent;
     }
+}
 
+/**
+ * @brief have the send queue of a session flushed at the end of this
+ * wakeup. called after something is queued.
+ * 
+ * @param by the session.
+ * @return int 0 on success, -1 if the session is unknown.
+ */
+int Ldpd::scheduleFlush(LdpFsm* by) {
+    int fd = by->getFd();
+
+    // no socket yet: nothing to flush to, the output stays queued.
+    if (fd < 0) {
+        return 0;
+    }
 
+    if (_fds.count(fd) == 0 || _fds[fd] != by) {
+        log_error("got transmit request from unknow session.\n");
+        return -1;
+    }
 
-    _last_hello = _now;
+    _tx_pending.insert(fd);
 
-    free(buffer);
+    return 0;
+}
+
+void Ldpd::handleSessionWritable(int fd) {
+    if (_fds.count(fd) == 0) {
+        return;
+    }
+
+    LdpFsm *session = _fds[fd];
+
+    if (session->getState() == LdpSessionState::Connecting) {
+        completeConnect(fd, session);
+        return;
+    }
+
+    flushSession(fd);
 }
 
-ssize_t Ldpd::transmit(LdpFsm* by, const uint8_t *buffer, size_t len) {
-    for (std::pair<int, LdpFsm *> fd : _fds) {
-        if (fd.second == by) {
-            return write(fd.first, buffer, len);
+/**
+ * @brief write out as much of the session output queue as the socket takes.
+ * EPOLLOUT is watched on the fd for as long as something is left.
+ * 
+ * @param fd session fd.
+ */
+void Ldpd::flushSession(int fd) {
+    if (_fds.count(fd) == 0) {
+        return;
+    }
+
+    LdpFsm *session = _fds[fd];
+    LdpPduQueue &tx = session->getSendQueue();
+
+    if (tx.flush(fd) < 0) {
+        log_error("writev(): %s - removing.\n", strerror(errno));
+
+        if (session->getState() == LdpSessionState::Initialized) {
+            rejectSession(fd, session, -1);
+            return;
         }
+
+        shutdownSession(session, -1);
+        removeSession(session);
+        return;
+    }
+
+    if (tx.pending() > 0 && _tx_wait.count(fd) == 0) {
+        _ev.modify(fd, EPOLLIN | EPOLLOUT);
+        _tx_wait.insert(fd);
+    }
+
+    if (tx.pending() == 0 && _tx_wait.count(fd) != 0) {
+        _ev.modify(fd, EPOLLIN);
+        _tx_wait.erase(fd);
     }
+}
 
-    log_error("got transmit request from unknow session.\n");
+void Ldpd::flushSessions() {
+    std::set<int> pending;
 
-    return -1;
+    // flushSession() may drop sessions, which touches _tx_pending.
+    pending.swap(_tx_pending);
+
+    for (int fd : pending) {
+        flushSession(fd);
+    }
 }
 
 void Ldpd::createSession(uint32_t nei_id, uint16_t nei_ls) {
     uint64_t key = LDP_KEY(nei_id, nei_ls);
 
-    log_info("creating new session with lsr-id: %s:%u...\n", InetNtop(nei_id).str, nei_ls);
-
     if (_transports.count(key) == 0 || _fsms.count(key) != 0) {
         log_warn("create-s called when no hello from remote, or session already exist.\n");
         return;
     }
 
-    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (_backoffs.count(key) != 0 && _now < _backoffs[key].next) {
+        return;
+    }
+
+    log_info("creating new session with lsr-id: %s:%u...\n", InetNtop(nei_id).str, nei_ls);
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
 
     if (fd < 0) {
         log_error("socket(): %s.\n", strerror(errno));
@@ -1007,51 +1580,181 @@ void Ldpd::createSession(uint32_t nei_id, uint16_t nei_ls) {
 
     if (bind(fd, (const sockaddr *) &local, sizeof(local)) < 0) {
         log_error("bind(): %s.\n", strerror(errno));
-        return;
-    }
-
-    if (connect(fd, (const sockaddr *) &remote, sizeof(local)) < 0) {
-        log_error("connect(): %s.\n", strerror(errno));
+        close(fd);
         return;
     }
 
     int ttl = 255;
     if (setsockopt(fd, IPPROTO_IP, IP_TTL, &ttl, sizeof(ttl)) < 0) {
         log_fatal("setsockopt(): %s.\n", strerror(errno));
+        close(fd);
         return;
     }
 
-    log_info("tcp connection to %s:%u established.\n", InetNtop(remote.sin_addr.s_addr).str, ntohs(remote.sin_port));
-
     LdpFsm *session = new LdpFsm(this);
 
     _fsms[key] = session;
     _fds[fd] = session;
 
-    session->init(nei_id, nei_ls);
+    session->setFd(fd);
+    session->connecting(nei_id, nei_ls);
+
+    // the connect completes (or fails) in the background - we get EPOLLOUT
+    // on the fd when it is done, see completeConnect().
+    if (connect(fd, (const sockaddr *) &remote, sizeof(remote)) < 0 && errno != EINPROGRESS) {
+        log_error("connect(): %s.\n", strerror(errno));
+        abortConnect(fd, session);
+        return;
+    }
+
+    LdpConnect &conn = _connects[fd];
+
+    conn.ldpd = this;
+    conn.fd = fd;
+    conn.timeout.setHandler(Ldpd::handleConnectTimer, &conn);
+
+    _timers.schedule(&conn.timeout, _now + LDP_CONNECT_TIMEOUT);
+    _ev.add(fd, EPOLLOUT);
+}
+
+/**
+ * @brief finish a non-blocking connect once the fd reports writable (or
+ * error), and start the session on it.
+ * 
+ * @param fd session fd.
+ * @param session the session, in connecting state.
+ */
+void Ldpd::completeConnect(int fd, LdpFsm *session) {
+    int err = 0;
+    socklen_t errlen = sizeof(err);
+
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &errlen) < 0) {
+        err = errno;
+    }
+
+    if (err != 0) {
+        log_error("connect(): %s.\n", strerror(err));
+        abortConnect(fd, session);
+        return;
+    }
+
+    _connects.erase(fd);
+    _ev.modify(fd, EPOLLIN);
+
+    log_info("tcp connection to %s established.\n", InetNtop(_transports[LDP_KEY(session->getNeighborId(), session->getNeighborLabelSpace())]).str);
+
+    if (session->init(session->getNeighborId(), session->getNeighborLabelSpace()) < 0) {
+        shutdownSession(session, -1);
+        removeSession(session);
+    }
+}
+
+/**
+ * @brief give up on a connect that failed or timed out. the session is
+ * deleted and the next attempt to the neighbor is delayed (exponential
+ * backoff).
+ * 
+ * @param fd session fd.
+ * @param session the session, in connecting state.
+ */
+void Ldpd::abortConnect(int fd, LdpFsm *session) {
+    uint64_t key = LDP_KEY(session->getNeighborId(), session->getNeighborLabelSpace());
+
+    if (_connects.count(fd) != 0) {
+        _ev.remove(fd);
+        _connects.erase(fd);
+    }
+
+    close(fd);
+    _closed.insert(fd);
+
+    _fds.erase(fd);
+    _fsms.erase(key);
+
+    LdpConnectBackoff &backoff = _backoffs[key];
+
+    if (backoff.delay == 0) {
+        backoff.delay = LDP_CONNECT_BACKOFF_INIT;
+    } else {
+        backoff.delay = backoff.delay * 2 > LDP_CONNECT_BACKOFF_MAX ? LDP_CONNECT_BACKOFF_MAX : backoff.delay * 2;
+    }
+
+    backoff.next = _now + backoff.delay;
+
+    log_info("connect to %s:%u failed, retrying in %u ms.\n", InetNtop(session->getNeighborId()).str, session->getNeighborLabelSpace(), backoff.delay);
+
+    delete session;
 }
 
 void Ldpd::scanInterfaces() {
     log_debug("scanning interfaces...\n");
-    _last_scan = _now;
     _ifaces = _router->getInterfaces();
+
+    updateHelloTargets();
+
+    // peers may be reachable now, or the loopback may have shown up.
+    retryUnresolved();
+}
+
+/**
+ * @brief work out the outgoing interface and source address for hellos on
+ * each of the ldp interfaces.
+ */
+void Ldpd::updateHelloTargets() {
+    _hello_targets.clear();
+
+    for (const std::string &ifname : _ldp_ifaces) {
+        struct in_pktinfo target;
+        memset(&target, 0, sizeof(target));
+
+        for (const Interface &iface : _ifaces) {
+            if (iface.ifname == ifname && iface.addresses.size() > 0) {
+                target.ipi_ifindex = iface.index;
+                target.ipi_spec_dst.s_addr = iface.addresses[0].address.prefix;
+            }
+        }
+
+        if (target.ipi_spec_dst.s_addr == 0) {
+            log_error("no interface with name %s, or no valid ip address on it.\n", ifname.c_str());
+            continue;
+        }
+
+        _hello_targets.push_back(target);
+    }
 }
 
-time_t Ldpd::now() const {
+/**
+ * @brief get the time.
+ * 
+ * @return uint64_t ms on the monotonic clock, as of the last wakeup.
+ */
+uint64_t Ldpd::now() const {
     return _now;
 }
 
-uint16_t Ldpd::getHoldTime(uint64_t of) {
+TimerWheel& Ldpd::getTimerWheel() {
+    return _timers;
+}
+
+/**
+ * @brief get the hold time of an adjacency: the lower of ours and theirs.
+ * 
+ * @param of adjacency key.
+ * @return uint32_t hold time in ms.
+ */
+uint32_t Ldpd::getHoldTime(uint64_t of) {
     if (_holds.count(of) == 0) {
         return _hold;
     }
 
-    uint16_t peer_hold = _holds[of];
+    uint32_t peer_hold = _holds[of];
 
     if (peer_hold == 0) {
         peer_hold = LDP_DEF_HELLO_HOLD;
     }
 
+    peer_hold *= 1000;
+
     return peer_hold < _hold ? peer_hold : _hold;
 }
 
@@ -1066,6 +1769,15 @@ void Ldpd::installMapping(uint64_t key, LdpLabelMapping &mapping) {
 
     if (_addresses.count(key) == 0) {
         log_error("mapping exists, but no addresses?\n");
+        _unresolved.insert(mapping.fec);
+        return;
+    }
+
+    uint64_t active = _mappings.getActive(mapping.fec);
+
+    if (active != 0 && active != key) {
+        // fec already switched w/ another peer's binding; keep this one
+        // around in case that one goes away.
         return;
     }
 
@@ -1122,9 +1834,22 @@ void Ldpd::installMapping(uint64_t key, LdpLabelMapping &mapping) {
 
     if (nh_iface == nullptr) {
         log_error("cannot find a way to reach the neighbor.\n");
+        _unresolved.insert(mapping.fec);
         return;
     }
 
+    // keep the label a mapping was installed w/ before, if any.
+    if (mapping.in_label == 0) {
+        uint32_t label = allocateLabel();
+
+        if (label == LDP_LABEL_NONE) {
+            _unresolved.insert(mapping.fec);
+            return;
+        }
+
+        mapping.in_label = label;
+    }
+
     Ipv4Route *ir = new Ipv4Route();
 
     ir->gw = nh_address;
@@ -1142,8 +1867,6 @@ void Ldpd::installMapping(uint64_t key, LdpLabelMapping &mapping) {
     
     _router->addRoute(ir);
 
-    mapping.in_label = getNextLabel();
-
     MplsRoute *mr = new MplsRoute();
 
     mr->in_label = mapping.in_label;
@@ -1158,61 +1881,107 @@ void Ldpd::installMapping(uint64_t key, LdpLabelMapping &mapping) {
     log_debug("adding route: in %u out %u by %s.\n", mapping.in_label, mapping.out_label, nei_addr_str);
 
     _router->addRoute(mr);
+
+    _mappings.setActive(mapping.fec, key);
 }
 
-void Ldpd::refreshMappings() {
-    uint64_t self_key = LDP_KEY(_id, _space);
+/**
+ * @brief remove the routes installed for a remote binding, if it is the one
+ * in use for its fec. the binding itself (and its in label) is kept.
+ *
+ * @param key key of the peer the binding is from.
+ * @param mapping the binding.
+ */
+void Ldpd::uninstallMapping(uint64_t key, const LdpLabelMapping &mapping) {
+    if (_mappings.getActive(mapping.fec) != key) {
+        return;
+    }
 
-    // not using for-iter, since we need ref to LdpLabelMapping object.
-    for (std::map<uint64_t, std::vector<LdpLabelMapping>>::iterator i = _mappings.begin(); i != _mappings.end(); ++i) {
-        for (LdpLabelMapping &mapping : i->second) {
-            if (self_key == i->first) {
-                continue;
-            }
+    MplsRoute m = MplsRoute();
+    m.in_label = mapping.in_label;
+    _router->deleteRoute(&m);
 
-            installMapping(i->first, mapping);
-        }
+    Ipv4Route r = Ipv4Route();
+    r.dst = mapping.fec.prefix;
+    r.dst_len = mapping.fec.len;
+
+    if (mapping.out_label != 3) {
+        r.mpls_encap = true;
+        r.mpls_stack.push_back(mapping.out_label);
     }
 
-    int lo_ifid = -1;
+    _router->deleteRoute(&r);
 
-    for (Interface &iface : _ifaces) {
-        if (iface.loopback) {
-            lo_ifid = iface.index;
-        }
-    }
+    _mappings.setActive(mapping.fec, 0);
+}
 
-    if (lo_ifid < 0) {
-        log_error("cannot find loopback interface - don't know how to install label for local router.\n");
-        return;
-    }
+/**
+ * @brief install the binding of another peer for a fec, after the one in use
+ * went away. peers are tried in the order their bindings came in.
+ *
+ * @param fec the fec.
+ */
+void Ldpd::installAlternative(const Prefix &fec) {
+    const std::vector<uint64_t> *peers = _mappings.getPeers(fec);
 
-    if (_mappings.count(self_key) == 0) {
-        log_error("no local mappings vector? something is not quite right.\n");
+    if (peers == nullptr) {
         return;
     }
 
-    std::vector<LdpLabelMapping> local_mappings = _mappings[self_key];
+    uint64_t self_key = LDP_KEY(_id, _space);
+
+    // copy: installMapping() does not change the peer list, but be safe.
+    std::vector<uint64_t> candidates = *peers;
 
-    for (const LdpLabelMapping &mapping : local_mappings) {
-        if (!shouldInstall(mapping)) {
+    for (uint64_t peer : candidates) {
+        if (peer == self_key) {
             continue;
         }
 
-        log_debug("adding route for delivering traffic for label %u locally...\n", mapping.in_label);
+        LdpLabelMapping *mapping = _mappings.find(peer, fec);
 
-        MplsRoute *route = new MplsRoute();
+        if (mapping == nullptr) {
+            continue;
+        }
+
+        installMapping(peer, *mapping);
+
+        if (_mappings.getActive(fec) != 0) {
+            return;
+        }
+    }
+}
 
-        route->in_label = mapping.in_label;
-        route->oif = lo_ifid;
+/**
+ * @brief queue a fec to be looked at on the next refresh.
+ *
+ * @param fec the fec.
+ */
+void Ldpd::markDirty(const Prefix &fec) {
+    _dirty.push(fec);
+}
 
-        _router->addRoute(route);
+/**
+ * @brief queue the fecs that could not be installed so far for another try.
+ */
+void Ldpd::retryUnresolved() {
+    for (const Prefix &fec : _unresolved) {
+        _dirty.push(fec);
     }
 
-    for (std::map<uint64_t, std::set<LdpLabelMapping>>::iterator i = _pending_delete_mappings.begin(); i != _pending_delete_mappings.end(); ++i) {
+    _unresolved.clear();
+}
+
+/**
+ * @brief remove the bindings withdrawn by peers, or left behind by sessions
+ * that went down. fecs that lost the binding in use are marked dirty, so
+ * another one is installed and advertised.
+ */
+void Ldpd::deletePendingMappings() {
+    for (std::map<uint64_t, LdpLabelMappingSet>::iterator i = _pending_delete_mappings.begin(); i != _pending_delete_mappings.end(); ++i) {
         uint64_t key = i->first;
 
-        for (std::set<LdpLabelMapping>::iterator j = i->second.begin(); j != i->second.end(); j = i->second.erase(j)) {
+        for (LdpLabelMappingSet::iterator j = i->second.begin(); j != i->second.end(); j = i->second.erase(j)) {
             if (!j->remote) {
                 MplsRoute route = MplsRoute();
                 route.in_label = j->in_label;
@@ -1221,176 +1990,334 @@ void Ldpd::refreshMappings() {
             }
 
             // if not local, in_label is not filled. find out what was assiged by looking at the mapping
-            if (_mappings.count(key) == 0) {
+            LdpLabelMapping *k = _mappings.find(key, j->fec);
+
+            if (k == nullptr) {
                 log_error("no mapping ever existed but trying to remove? something is wrong.\n");
                 continue;
             }
 
-            std::vector<LdpLabelMapping> &mappings = _mappings[key];
+            if (!k->remote) {
+                log_error("mapping with type local found in mappingdb for remote? something is wrong.\n");
+                continue;
+            }
 
-            for (std::vector<LdpLabelMapping>::iterator k = mappings.begin(); k != mappings.end(); ) {
-                if (!k->remote) {
-                    log_error("mapping with type local found in mappingdb for remote? something is wrong.\n");
-                    ++k;
-                    continue;
+            Prefix fec = k->fec;
+            bool was_active = _mappings.getActive(fec) == key;
+
+            uninstallMapping(key, *k);
+            releaseLabel(k->in_label);
+            _mappings.remove(key, fec);
+
+            if (was_active) {
+                // the label we advertised for the fec is gone - whatever
+                // binding replaces it is advertised again.
+                for (std::pair<const uint64_t, LdpLabelMappingSet> &exported : _exported_mappings) {
+                    exported.second.erase(*j);
                 }
 
-                if (j->fec == k->fec) {
-                    MplsRoute m = MplsRoute();
-                    m.in_label = k->in_label;
-                    _router->deleteRoute(&m);
+                markDirty(fec);
+            }
+        }
+    }
+}
+
+/**
+ * @brief bring the routes of a fec in line w/ its bindings, and queue it to
+ * be (re-)advertised to every session.
+ *
+ * @param fec the fec.
+ * @param lo_ifid index of the loopback interface, or -1 if there is none.
+ */
+void Ldpd::refreshFec(const Prefix &fec, int lo_ifid) {
+    uint64_t self_key = LDP_KEY(_id, _space);
 
-                    Ipv4Route r = Ipv4Route();
-                    r.dst = k->fec.prefix;
-                    r.dst_len = k->fec.len;
+    _unresolved.erase(fec);
 
-                    if (k->out_label != 3) {
-                        r.mpls_encap = true;
-                        r.mpls_stack.push_back(k->out_label);
-                    }
-                    
-                    _router->deleteRoute(&r);
+    const LdpLabelMapping *local = _mappings.find(self_key, fec);
 
-                    k = mappings.erase(k);
-                    continue;
-                }
+    if (local != nullptr && shouldInstall(*local)) {
+        if (lo_ifid < 0) {
+            _unresolved.insert(fec);
+        } else {
+            log_debug("adding route for delivering traffic for label %u locally...\n", local->in_label);
 
-                ++k;
-            }
-            
-            
+            MplsRoute *route = new MplsRoute();
+
+            route->in_label = local->in_label;
+            route->oif = lo_ifid;
+
+            _router->addRoute(route);
         }
+    }
+
+    uint64_t active = _mappings.getActive(fec);
+    LdpLabelMapping *mapping = active == 0 ? nullptr : _mappings.find(active, fec);
 
+    if (mapping != nullptr) {
+        installMapping(active, *mapping);
+    } else {
+        installAlternative(fec);
     }
 
-    for (std::pair<uint64_t, LdpFsm *> session : _fsms) {
-        if (session.second->getState() != LdpSessionState::Operational) {
-            continue;
-        }
+    for (std::pair<const uint64_t, FecQueue> &queue : _export_queues) {
+        queue.second.push(fec);
+    }
+}
+
+/**
+ * @brief send a session the bindings of the fecs in its export queue that
+ * it does not have yet. stops when the send queue gets congested; the rest
+ * is left queued for a later refresh.
+ *
+ * @param key key of the peer.
+ * @param fsm the session.
+ */
+void Ldpd::exportMappings(uint64_t key, LdpFsm *fsm) {
+    std::map<uint64_t, FecQueue>::iterator queue = _export_queues.find(key);
+
+    if (queue == _export_queues.end() || queue->second.empty()) {
+        return;
+    }
 
-        LdpPdu pdu = LdpPdu();
+    LdpPduQueue &tx = fsm->getSendQueue();
 
-        uint64_t nei_key = session.first;
-        uint64_t local_key = LDP_KEY(_id, _space);
+    // peer is not keeping up - don't queue more mappings for them until
+    // the queue drains.
+    if (tx.congested()) {
+        return;
+    }
 
-        const char *nei_id_str = InetNtop(session.second->getNeighborId()).str;
+    LdpPduPacker packer = LdpPduPacker(fsm);
+    LdpLabelMappingSet &exported = _exported_mappings[key];
 
-        if (_exported_mappings.count(nei_key) == 0) {
-            _exported_mappings[nei_key] = std::set<LdpLabelMapping>();
-        }
+    uint64_t local_key = LDP_KEY(_id, _space);
 
-        bool send = false;
+    const char *nei_id_str = InetNtop(fsm->getNeighborId()).str;
 
-        for (const std::pair<uint64_t, std::vector<LdpLabelMapping>> &mappings : _mappings) {
-            uint64_t this_key = mappings.first;
-            uint32_t src_id = (uint32_t) (this_key >> sizeof(uint16_t));
-            const char *src_id_str = InetNtop(src_id).str;
+    bool failed = false;
 
-            if (this_key == nei_key) {
-                continue;
-            }
+    while (!queue->second.empty()) {
+        const Prefix &fec = queue->second.front();
+        const std::vector<uint64_t> *peers = _mappings.getPeers(fec);
+
+        if (peers != nullptr) {
+            for (uint64_t this_key : *peers) {
+                if (this_key == key) {
+                    continue;
+                }
+
+                const LdpLabelMapping *mapping = _mappings.find(this_key, fec);
+
+                if (mapping == nullptr) {
+                    continue;
+                }
 
-            for (const LdpLabelMapping &mapping : mappings.second) {
-                if (!mapping.remote && this_key != local_key) {
+                if (!mapping->remote && this_key != local_key) {
                     log_error("got non-remote mapping in non-local mapping db?\n");
                     continue;
                 }
 
-                if (_exported_mappings[nei_key].count(mapping) != 0) {
+                if (exported.count(*mapping) != 0) {
                     continue;
                 }
 
-                if (!shouldSend(mapping)) {
+                if (!shouldSend(*mapping)) {
                     continue;
                 }
 
-                _exported_mappings[nei_key].insert(mapping);
+                if (tx.pending() + packer.length() >= LDP_TXQ_HIGH_WATERMARK) {
+                    failed = true;
+                    break;
+                }
 
-                LdpMessage *mapping_msg = new LdpMessage();
-                pdu.addMessage(mapping_msg);
+                LdpMappingAdvertisement advert;
 
-                mapping_msg->setType(LDP_MSGTYPE_LABEL_MAPPING);
-                mapping_msg->setId(getNextMessageId());
+                advert.ldpd = this;
+                advert.mapping = mapping;
 
-                LdpRawTlv *fec = new LdpRawTlv();
-                mapping_msg->addTlv(fec);
+                if (packer.add(Ldpd::encodeMapping, &advert) < 0) {
+                    failed = true;
+                    break;
+                }
 
-                LdpFecTlvValue fec_val = LdpFecTlvValue();
+                exported.insert(*mapping);
 
-                LdpFecPrefixElement *pel = new LdpFecPrefixElement();
+                if (mapping->remote) {
+                    uint32_t src_id = (uint32_t) (this_key >> sizeof(uint16_t));
 
-                pel->setPrefix(mapping.fec.prefix);
-                pel->setPrefixLength(mapping.fec.len);
+                    log_debug("sending %s transit binding fec %s/%u swap %u with %u, learned from %s.\n", nei_id_str, InetNtop(fec.prefix).str, fec.len, mapping->in_label, mapping->out_label, InetNtop(src_id).str);
+                } else {
+                    log_debug("sending %s local binding %s/%u lbl %u.\n", nei_id_str, InetNtop(fec.prefix).str, fec.len, mapping->in_label);
+                }
+            }
+        }
 
-                fec_val.addElement(pel);
-                
-                fec->setValue(&fec_val);
+        if (failed) {
+            // fec stays queued; what was sent of it is in exported already.
+            break;
+        }
 
-                LdpRawTlv *lbl = new LdpRawTlv();
+        queue->second.pop();
+    }
 
-                LdpGenericLabelTlvValue lbl_val = LdpGenericLabelTlvValue();
-                lbl_val.setLabel(mapping.in_label);
+    packer.flush();
+}
 
-                lbl->setValue(&lbl_val);
+/**
+ * @brief process what changed since the last refresh: delete withdrawn
+ * bindings, install / advertise the bindings of the dirty fecs, and send
+ * each session what is queued for it. nothing is done for fecs that did
+ * not change.
+ */
+void Ldpd::refreshMappings() {
+    deletePendingMappings();
 
-                mapping_msg->addTlv(lbl);
+    if (!_dirty.empty()) {
+        int lo_ifid = -1;
 
-                mapping_msg->recalculateLength();
+        for (Interface &iface : _ifaces) {
+            if (iface.loopback) {
+                lo_ifid = iface.index;
+            }
+        }
 
-                send = true;
+        if (lo_ifid < 0) {
+            log_error("cannot find loopback interface - don't know how to install label for local router.\n");
+        }
 
-                if (mapping.remote) {
-                    log_debug("sending %s transit binding fec %s/%u swap %u with %u, learned from %s.\n", nei_id_str, InetNtop(mapping.fec.prefix).str, mapping.fec.len, mapping.in_label, mapping.out_label, src_id_str);
-                } else {
-                    log_debug("sending %s local binding %s/%u lbl %u.\n", nei_id_str, InetNtop(mapping.fec.prefix).str, mapping.fec.len, mapping.in_label);
-                }
+        while (!_dirty.empty()) {
+            Prefix fec = _dirty.front();
+            _dirty.pop();
 
-            }
+            refreshFec(fec, lo_ifid);
         }
+    }
 
-        if (send) {
-            session.second->send(pdu);
+    for (std::pair<uint64_t, LdpFsm *> session : _fsms) {
+        if (session.second->getState() != LdpSessionState::Operational) {
+            continue;
         }
+
+        exportMappings(session.first, session.second);
+    }
+}
+
+/**
+ * @brief packer callback: encode a label mapping message w/ a single prefix
+ * fec element.
+ * 
+ * @param advertisement the LdpMappingAdvertisement.
+ * @param writer pdu writer.
+ * @return ssize_t size of the message, or -1 if it does not fit.
+ */
+ssize_t Ldpd::encodeMapping(void *advertisement, LdpPduWriter &writer) {
+    LdpMappingAdvertisement *advert = (LdpMappingAdvertisement *) advertisement;
+    const LdpLabelMapping &mapping = *advert->mapping;
+
+    writer.beginMessage(LDP_MSGTYPE_LABEL_MAPPING, advert->ldpd->getNextMessageId());
+
+    writer.beginTlv(LDP_TLVTYPE_FEC);
+    writer.putU8(LDP_FEC_PREFIX);
+    writer.putU16(1);
+    writer.putU8(mapping.fec.len);
+    writer.put(&mapping.fec.prefix, (mapping.fec.len + 7) / 8);
+    writer.endTlv();
+
+    writer.beginTlv(LDP_TLVTYPE_GENERIC_LABEL);
+    writer.putU32(mapping.in_label);
+    writer.endTlv();
+
+    return writer.endMessage();
+}
+
+/**
+ * @brief packer callback: encode an address message w/ as many of the
+ * addresses not yet sent as fit in the pdu.
+ * 
+ * @param advertisement the LdpAddressAdvertisement. next is moved past the
+ * addresses encoded.
+ * @param writer pdu writer.
+ * @return ssize_t size of the message, or -1 if not even one address fits.
+ */
+ssize_t Ldpd::encodeAddresses(void *advertisement, LdpPduWriter &writer) {
+    LdpAddressAdvertisement *advert = (LdpAddressAdvertisement *) advertisement;
+
+    writer.beginMessage(LDP_MSGTYPE_ADDRESS, advert->ldpd->getNextMessageId());
+    writer.beginTlv(LDP_TLVTYPE_ADDRESS_LIST);
+    writer.putU16(1);
+
+    size_t count = advert->addresses.size() - advert->next;
+
+    if (count > writer.remaining() / sizeof(uint32_t)) {
+        count = writer.remaining() / sizeof(uint32_t);
+    }
+
+    if (count == 0 || writer.put(&advert->addresses[advert->next], count * sizeof(uint32_t)) < 0) {
+        return -1;
     }
+
+    size_t next = advert->next + count;
+
+    writer.endTlv();
+
+    ssize_t len = writer.endMessage();
+
+    if (len >= 0) {
+        advert->next = next;
+    }
+
+    return len;
 }
 
 void Ldpd::handleNewSession(LdpFsm* of) {
-    // send address list, label mapping, etc.
+    uint64_t key = LDP_KEY(of->getNeighborId(), of->getNeighborLabelSpace());
 
-    LdpPdu pdu = LdpPdu();
+    // session is up, next connect to them (if ever needed) starts w/o delay.
+    _backoffs.erase(key);
 
-    LdpMessage *addr_msg = new LdpMessage();
-    pdu.addMessage(addr_msg);
-    
-    addr_msg->setType(LDP_MSGTYPE_ADDRESS);
-    addr_msg->setId(getNextMessageId());
+    // they get every binding we have, over as many refreshes as it takes.
+    FecQueue &queue = _export_queues[key];
+    queue.clear();
+
+    for (const std::pair<const uint64_t, MappingDb::Bindings> &peer : _mappings.getPeers()) {
+        for (const std::pair<const Prefix, LdpLabelMapping> &binding : peer.second) {
+            queue.push(binding.first);
+        }
+    }
 
-    LdpRawTlv *addr_list_tlv = new LdpRawTlv();
-    addr_msg->addTlv(addr_list_tlv);
+    // send address list, label mapping, etc.
 
-    addr_list_tlv->setType(LDP_TLVTYPE_ADDRESS_LIST);
-    
-    LdpAddressTlvValue addr_list_val = LdpAddressTlvValue();
+    LdpAddressAdvertisement advert;
+
+    advert.ldpd = this;
+    advert.next = 0;
 
     // todo: handle interface/addr changes
     for (const Interface &iface : _ifaces) {
         if (std::find(_ldp_ifaces.begin(), _ldp_ifaces.end(), iface.ifname) != _ldp_ifaces.end()) {
             for (const InterfaceAddress &addr : iface.addresses) { // todo: filter out martian (127/8, etc)?
-                addr_list_val.addAddress(addr.address.prefix);
+                advert.addresses.push_back(addr.address.prefix);
             }
         }
     }
 
-    if (addr_list_val.getAddresses().size() == 0) {
+    if (advert.addresses.size() == 0) {
         log_warn("no addresses on any of the interfaces, what?\n");
         return;
     }
 
-    addr_list_tlv->setValue(&addr_list_val);
-    addr_msg->recalculateLength();
+    // split over as many address messages as it takes to stay within the max
+    // pdu length.
+    LdpPduPacker packer = LdpPduPacker(of);
+
+    while (advert.next < advert.addresses.size()) {
+        if (packer.add(Ldpd::encodeAddresses, &advert) < 0) {
+            return;
+        }
+    }
 
-    // don't need recalc-len for pdu, fsm does it in send()
-    of->send(pdu);
+    packer.flush();
 }
 
 void Ldpd::setImportPolicy(const RoutePolicy &policy) {
@@ -1414,31 +2341,39 @@ void Ldpd::setExportPolicy(const RoutePolicy &policy) {
 void Ldpd::handleRouteChange(void *self, RouteChange change, const Route *route) {
     Ldpd *ldpd = (Ldpd *) self;
 
-    log_debug("todo: see if we need to send/withdraw mapping.\n");
+    // mpls routes, and our own routes, do not change any binding.
+    if (route->getType() != RouteType::Ipv4 || route->protocol == RoutingProtocol::Ldp) {
+        return;
+    }
+
+    const Ipv4Route *v4 = (const Ipv4Route *) route;
+
+    if (change == RouteChange::AddedOrChanged && ldpd->_mappings.hasPeer(LDP_KEY(ldpd->_id, ldpd->_space))) {
+        ldpd->createLocalMapping(v4);
+    }
+
+    // todo: withdraw the local binding once the last route to it is gone.
+    ldpd->markDirty(Prefix(v4->dst, v4->dst_len));
 }
 
 void Ldpd::addRouteSource(RoutingProtocol proto) {
     _srcs.insert(proto);
 }
 
-uint32_t Ldpd::getNextLabel() const {
-    std::set<uint32_t> used = std::set<uint32_t>();
-
-    for (const std::pair<uint64_t, std::vector<LdpLabelMapping>> &mappings : _mappings) {
-        for (const LdpLabelMapping &mapping : mappings.second) {
-            used.insert(mapping.in_label);
-        }
-    }
+uint32_t Ldpd::allocateLabel() {
+    return _labels.allocate();
+}
 
-    for (uint32_t i = LDP_MIN_LBL; i <= LDP_MAX_LBL; ++i) {
-        if (used.count(i) == 0) {
-            return i;
-        }
+void Ldpd::releaseLabel(uint32_t label) {
+    if (label == 0) {
+        // remote mapping never installed.
+        return;
     }
 
-    log_error("we have run out of labels.\n");
+    _labels.release(label);
 
-    return 0xffffffff;
+    // whatever ran out of labels may get one now.
+    retryUnresolved();
 }
 
 void Ldpd::createLocalMappings() {
@@ -1446,86 +2381,87 @@ void Ldpd::createLocalMappings() {
 
     uint64_t local_key = LDP_KEY(_id, _space);
 
-    if (_mappings.count(local_key) != 0) {
+    if (_mappings.hasPeer(local_key)) {
         log_error("local mapping already exists. updates are handled by the change listeners.\n");
         return;
     }
 
-    _mappings[local_key] = std::vector<LdpLabelMapping>();
+    _mappings.getPeers()[local_key] = MappingDb::Bindings();
 
     for (const Route* r : _router->getFib()) {
         if (r->getType() != RouteType::Ipv4) {
             continue;
         }
 
-        Ipv4Route *route = (Ipv4Route *) r;
-        Prefix pfx = Prefix(route->dst, route->dst_len);
-
-        if (_srcs.count(route->protocol) == 0) {
-            log_debug("export reject %s/%u - protocol %u not allowed.\n", InetNtop(route->dst).str, route->dst_len, route->protocol);
-            continue;
-        }
-
-        if (_export.apply(pfx) != FilterAction::Accept) {
-            log_debug("export reject %s/%u - rejected by filter.\n", InetNtop(route->dst).str, route->dst_len);
-            continue;
+        if (!createLocalMapping((const Ipv4Route *) r)) {
+            return;
         }
+    }
+}
 
-        uint32_t label = getNextLabel();
+/**
+ * @brief create a local binding for the destination of a route, if the
+ * route is to be exported and there is no binding for it yet. the fec is
+ * marked dirty, so the binding is installed and advertised.
+ *
+ * @param route the route.
+ * @return false if out of labels, true otherwise.
+ */
+bool Ldpd::createLocalMapping(const Ipv4Route *route) {
+    uint64_t local_key = LDP_KEY(_id, _space);
+    Prefix pfx = Prefix(route->dst, route->dst_len);
 
-        if (label > LDP_MAX_LBL) {
-            return;
-        }
+    if (_srcs.count(route->protocol) == 0) {
+        log_debug("export reject %s/%u - protocol %u not allowed.\n", InetNtop(route->dst).str, route->dst_len, route->protocol);
+        return true;
+    }
 
-        LdpLabelMapping mapping = LdpLabelMapping();
+    if (_export.apply(pfx) != FilterAction::Accept) {
+        log_debug("export reject %s/%u - rejected by filter.\n", InetNtop(route->dst).str, route->dst_len);
+        return true;
+    }
 
-        mapping.remote = false;
-        mapping.fec = pfx;
-        mapping.in_label = label;
+    if (_mappings.find(local_key, pfx) != nullptr) {
+        // more than one route to the prefix - one binding is enough.
+        return true;
+    }
 
-        _mappings[local_key].push_back(mapping);
+    uint32_t label = allocateLabel();
 
-        log_debug("created binding %s/%u lbl %u.\n", InetNtop(pfx.prefix).str, pfx.len, label);
+    if (label == LDP_LABEL_NONE) {
+        return false;
     }
-}
 
-bool Ldpd::installed(const LdpLabelMapping &mapping) {
-    bool has_mpls = false, has_v4 = false;
-    for (const Route* route : _router->getRoutes()) {
-        if (route->getType() == RouteType::Mpls) {
-            MplsRoute *mpls = (MplsRoute *) route;
+    LdpLabelMapping mapping = LdpLabelMapping();
 
-            if (mpls->in_label == mapping.in_label) {
-                has_mpls = true;
-                continue;
-            }
-        }
+    mapping.remote = false;
+    mapping.fec = pfx;
+    mapping.in_label = label;
 
-        if (route->getType() == RouteType::Ipv4) {
-            Ipv4Route *v4 = (Ipv4Route *) route;
+    _mappings.update(local_key, mapping);
+    markDirty(pfx);
 
-            if (v4->dst == mapping.fec.prefix || v4->dst_len == mapping.fec.len) {
-                has_v4 = true;
-                continue;
-            }
-        }
-    }
+    log_debug("created binding %s/%u lbl %u.\n", InetNtop(pfx.prefix).str, pfx.len, label);
 
-    if (mapping.remote) {
-        if (has_mpls && !has_v4) {
-            log_warn("inconsistent: mpls in label exists but no v4 route installed for a remote binding?\n");
-        }
+    return true;
+}
 
-        if (has_mpls) {
-            return true;
-        }
+/**
+ * @brief check if the routes for a binding are in the rib.
+ *
+ * @param mapping the binding.
+ * @return true if the route for its in label is there.
+ */
+bool Ldpd::installed(const LdpLabelMapping &mapping) {
+    if (_router->findMplsRoute(mapping.in_label) == nullptr) {
+        return false;
     }
 
-    if (!mapping.remote && has_mpls) {
-        return true;
+    if (mapping.remote && _router->findIpv4Route(mapping.fec) == nullptr) {
+        log_warn("inconsistent: mpls in label exists but no v4 route installed for a remote binding?\n");
     }
 
-    return false;
+    return true;
 }
 
 bool Ldpd::shouldSend(const LdpLabelMapping &mapping) {
@@ -1551,12 +2487,10 @@ bool Ldpd::shouldInstall(const LdpLabelMapping &mapping, uint64_t key) {
             return false;
         }
 
-        if (_mappings.count(key) != 0) {
-            for (const LdpLabelMapping &m : _mappings[key]) {
-                if (mapping == m && m.hidden) { // note: not a real eq check; see mapping op == code.
-                    return false;
-                }
-            }
+        const LdpLabelMapping *m = _mappings.find(key, mapping.fec);
+
+        if (m != nullptr && m->hidden) {
+            return false;
         }
     }
 
@@ -0,0 +1,184 @@
+#include "core/mapping-db.hh"
+
+#include <algorithm>
+
+namespace ldpd {
+
+size_t PrefixHash::operator()(const Prefix &prefix) const {
+    uint64_t key = ((uint64_t) prefix.prefix << 8) | prefix.len;
+
+    // multiplicative hash: the high bits of the product depend on all bits
+    // of the key.
+    return (key * 0x9e3779b97f4a7c15ULL) >> 24;
+}
+
+MappingDb::MappingDb() : _peers(), _fecs() {
+    _size = 0;
+}
+
+/**
+ * @brief add a binding, or update the one the peer already has for the fec.
+ *
+ * note: on update only the out label is taken over - the in label, and
+ * whether the binding is hidden, stay as they were.
+ *
+ * @param peer key of the peer (LDP_KEY).
+ * @param mapping the binding.
+ * @return LdpLabelMapping* the binding in the db.
+ */
+LdpLabelMapping* MappingDb::update(uint64_t peer, const LdpLabelMapping &mapping) {
+    Bindings &bindings = _peers[peer];
+    Bindings::iterator it = bindings.find(mapping.fec);
+
+    if (it != bindings.end()) {
+        it->second.out_label = mapping.out_label;
+        return &it->second;
+    }
+
+    LdpLabelMapping &added = bindings[mapping.fec];
+    added = mapping;
+
+    FecEntry &entry = _fecs[mapping.fec];
+
+    if (entry.peers.empty()) {
+        entry.active = 0;
+    }
+
+    entry.peers.push_back(peer);
+    ++_size;
+
+    return &added;
+}
+
+/**
+ * @brief get the binding of a peer for a fec.
+ *
+ * @param peer key of the peer.
+ * @param fec the fec.
+ * @return LdpLabelMapping* the binding, or nullptr if the peer has none.
+ */
+LdpLabelMapping* MappingDb::find(uint64_t peer, const Prefix &fec) {
+    std::map<uint64_t, Bindings>::iterator p = _peers.find(peer);
+
+    if (p == _peers.end()) {
+        return nullptr;
+    }
+
+    Bindings::iterator it = p->second.find(fec);
+
+    return it == p->second.end() ? nullptr : &it->second;
+}
+
+const LdpLabelMapping* MappingDb::find(uint64_t peer, const Prefix &fec) const {
+    return const_cast<MappingDb *>(this)->find(peer, fec);
+}
+
+/**
+ * @brief remove the binding of a peer for a fec. if it was the one in use,
+ * none is in use afterwards.
+ *
+ * @param peer key of the peer.
+ * @param fec the fec.
+ * @return int 0 on success, -1 if the peer has no binding for the fec.
+ */
+int MappingDb::remove(uint64_t peer, const Prefix &fec) {
+    std::map<uint64_t, Bindings>::iterator p = _peers.find(peer);
+
+    if (p == _peers.end() || p->second.erase(fec) == 0) {
+        return -1;
+    }
+
+    --_size;
+
+    std::unordered_map<Prefix, FecEntry, PrefixHash>::iterator f = _fecs.find(fec);
+
+    if (f == _fecs.end()) {
+        return 0;
+    }
+
+    std::vector<uint64_t> &peers = f->second.peers;
+    std::vector<uint64_t>::iterator it = std::find(peers.begin(), peers.end(), peer);
+
+    if (it != peers.end()) {
+        peers.erase(it);
+    }
+
+    if (f->second.active == peer) {
+        f->second.active = 0;
+    }
+
+    if (peers.empty()) {
+        _fecs.erase(f);
+    }
+
+    return 0;
+}
+
+bool MappingDb::hasPeer(uint64_t peer) const {
+    return _peers.count(peer) != 0;
+}
+
+/**
+ * @brief get all bindings of a peer.
+ *
+ * @param peer key of the peer.
+ * @return Bindings* bindings by fec, or nullptr if the peer never had any.
+ */
+MappingDb::Bindings* MappingDb::getBindings(uint64_t peer) {
+    std::map<uint64_t, Bindings>::iterator p = _peers.find(peer);
+
+    return p == _peers.end() ? nullptr : &p->second;
+}
+
+/**
+ * @brief get the bindings of every peer.
+ *
+ * @return std::map<uint64_t, Bindings>& bindings by fec, by peer.
+ */
+std::map<uint64_t, MappingDb::Bindings>& MappingDb::getPeers() {
+    return _peers;
+}
+
+/**
+ * @brief get the peers w/ a binding for a fec.
+ *
+ * @param fec the fec.
+ * @return const std::vector<uint64_t>* keys of the peers, in the order their
+ * bindings were added, or nullptr if there are none.
+ */
+const std::vector<uint64_t>* MappingDb::getPeers(const Prefix &fec) const {
+    std::unordered_map<Prefix, FecEntry, PrefixHash>::const_iterator f = _fecs.find(fec);
+
+    return f == _fecs.end() ? nullptr : &f->second.peers;
+}
+
+/**
+ * @brief get the peer whose binding for a fec is in use.
+ *
+ * @param fec the fec.
+ * @return uint64_t key of the peer, or 0 if none is.
+ */
+uint64_t MappingDb::getActive(const Prefix &fec) const {
+    std::unordered_map<Prefix, FecEntry, PrefixHash>::const_iterator f = _fecs.find(fec);
+
+    return f == _fecs.end() ? 0 : f->second.active;
+}
+
+void MappingDb::setActive(const Prefix &fec, uint64_t peer) {
+    std::unordered_map<Prefix, FecEntry, PrefixHash>::iterator f = _fecs.find(fec);
+
+    if (f != _fecs.end()) {
+        f->second.active = peer;
+    }
+}
+
+/**
+ * @brief get number of bindings.
+ *
+ * @return size_t bindings, of all peers.
+ */
+size_t MappingDb::size() const {
+    return _size;
+}
+
+}
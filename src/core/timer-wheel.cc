@@ -0,0 +1,261 @@
+#include "utils/log.hh"
+#include "core/timer-wheel.hh"
+
+#include <string.h>
+
+namespace ldpd {
+
+Timer::Timer() {
+    _prev = nullptr;
+    _next = nullptr;
+    _expires = 0;
+    _handler = nullptr;
+    _data = nullptr;
+    _wheel = nullptr;
+    _level = 0;
+    _slot = 0;
+}
+
+Timer::Timer(__attribute__((unused)) const Timer &other) : Timer() {
+}
+
+Timer::~Timer() {
+    if (_wheel != nullptr) {
+        _wheel->cancel(this);
+    }
+}
+
+void Timer::setHandler(ldp_timer_handler_t handler, void *data) {
+    _handler = handler;
+    _data = data;
+}
+
+bool Timer::armed() const {
+    return _wheel != nullptr;
+}
+
+uint64_t Timer::getExpiry() const {
+    return _expires;
+}
+
+TimerWheel::TimerWheel(uint64_t now) {
+    memset(_slots, 0, sizeof(_slots));
+    memset(_occupied, 0, sizeof(_occupied));
+    _now = now;
+}
+
+TimerWheel::~TimerWheel() {
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; ++slot) {
+            while (_slots[level][slot] != nullptr) {
+                unlink(_slots[level][slot]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief arm a timer, or move an armed timer to a new expiry.
+ *
+ * @param timer the timer.
+ * @param expires tick to fire at. timers already due fire on the next
+ * advance().
+ */
+void TimerWheel::schedule(Timer *timer, uint64_t expires) {
+    if (timer->_wheel != nullptr) {
+        timer->_wheel->cancel(timer);
+    }
+
+    timer->_expires = expires;
+    place(timer);
+}
+
+/**
+ * @brief disarm a timer. does nothing if the timer is not armed.
+ *
+ * @param timer the timer.
+ */
+void TimerWheel::cancel(Timer *timer) {
+    if (timer->_wheel != this) {
+        return;
+    }
+
+    unlink(timer);
+}
+
+/**
+ * @brief move time forward, firing everything due on the way.
+ *
+ * @param now new time. time does not go backward; an older value only fires
+ * the timers that are due already.
+ */
+void TimerWheel::advance(uint64_t now) {
+    expire();
+
+    while (_now < now) {
+        uint64_t next = nextEvent();
+        uint64_t prev = _now;
+
+        _now = next < now ? next : now;
+
+        cascade(prev);
+        expire();
+    }
+}
+
+/**
+ * @brief get the earliest tick a timer may fire at. timers on the upper
+ * levels are only known to the slot, so this can be early - advancing to it
+ * then just moves the timers down.
+ *
+ * @return uint64_t tick, or TIMER_WHEEL_NEVER if nothing is armed.
+ */
+uint64_t TimerWheel::nextEvent() const {
+    uint64_t next = TIMER_WHEEL_NEVER;
+
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+        uint64_t bits = _occupied[level];
+
+        if (bits == 0) {
+            continue;
+        }
+
+        int shift = level * TIMER_WHEEL_BITS;
+        int slot = (int) ((_now >> shift) & (TIMER_WHEEL_SLOTS - 1));
+
+        uint64_t base = (_now >> (shift + TIMER_WHEEL_BITS)) << (shift + TIMER_WHEEL_BITS);
+
+        // level 0 slot of now may have been filled by a handler; the current
+        // slot of upper levels is always empty (see cascade()).
+        uint64_t ahead = level == 0 ? (bits & (~0ULL << slot)) : (slot == TIMER_WHEEL_SLOTS - 1 ? 0 : bits & (~0ULL << (slot + 1)));
+
+        uint64_t at;
+
+        if (ahead != 0) {
+            at = base + ((uint64_t) __builtin_ctzll(ahead) << shift);
+        } else if (level == TIMER_WHEEL_LEVELS - 1) {
+            // only far away timers are left at the top level: next round.
+            at = base + (1ULL << (shift + TIMER_WHEEL_BITS)) + ((uint64_t) __builtin_ctzll(bits) << shift);
+        } else {
+            continue;
+        }
+
+        if (at < next) {
+            next = at;
+        }
+    }
+
+    return next;
+}
+
+uint64_t TimerWheel::now() const {
+    return _now;
+}
+
+void TimerWheel::place(Timer *timer) {
+    uint64_t expires = timer->_expires < _now ? _now : timer->_expires;
+
+    // lowest level where the timer falls in the same block as now.
+    for (int level = 0; level < TIMER_WHEEL_LEVELS - 1; ++level) {
+        int shift = level * TIMER_WHEEL_BITS;
+
+        if ((expires >> (shift + TIMER_WHEEL_BITS)) == (_now >> (shift + TIMER_WHEEL_BITS))) {
+            link(timer, level, (int) ((expires >> shift) & (TIMER_WHEEL_SLOTS - 1)));
+            return;
+        }
+    }
+
+    int shift = (TIMER_WHEEL_LEVELS - 1) * TIMER_WHEEL_BITS;
+    link(timer, TIMER_WHEEL_LEVELS - 1, (int) ((expires >> shift) & (TIMER_WHEEL_SLOTS - 1)));
+}
+
+void TimerWheel::link(Timer *timer, int level, int slot) {
+    Timer *&head = _slots[level][slot];
+
+    timer->_prev = nullptr;
+    timer->_next = head;
+
+    if (head != nullptr) {
+        head->_prev = timer;
+    }
+
+    head = timer;
+
+    timer->_wheel = this;
+    timer->_level = (uint8_t) level;
+    timer->_slot = (uint8_t) slot;
+
+    _occupied[level] |= 1ULL << slot;
+}
+
+void TimerWheel::unlink(Timer *timer) {
+    Timer *&head = _slots[timer->_level][timer->_slot];
+
+    if (timer->_prev != nullptr) {
+        timer->_prev->_next = timer->_next;
+    } else {
+        head = timer->_next;
+    }
+
+    if (timer->_next != nullptr) {
+        timer->_next->_prev = timer->_prev;
+    }
+
+    if (head == nullptr) {
+        _occupied[timer->_level] &= ~(1ULL << timer->_slot);
+    }
+
+    timer->_prev = nullptr;
+    timer->_next = nullptr;
+    timer->_wheel = nullptr;
+}
+
+/**
+ * @brief after moving from prev to now, re-sort the timers in the slots we
+ * just entered on the upper levels to the levels below. top-down, so timers
+ * can trickle all the way down in one go.
+ *
+ * @param prev previous time.
+ */
+void TimerWheel::cascade(uint64_t prev) {
+    for (int level = TIMER_WHEEL_LEVELS - 1; level > 0; --level) {
+        int shift = level * TIMER_WHEEL_BITS;
+
+        if ((prev >> shift) == (_now >> shift)) {
+            continue;
+        }
+
+        int slot = (int) ((_now >> shift) & (TIMER_WHEEL_SLOTS - 1));
+
+        Timer *timer = _slots[level][slot];
+
+        _slots[level][slot] = nullptr;
+        _occupied[level] &= ~(1ULL << slot);
+
+        while (timer != nullptr) {
+            Timer *next = timer->_next;
+            place(timer);
+            timer = next;
+        }
+    }
+}
+
+void TimerWheel::expire() {
+    int slot = (int) (_now & (TIMER_WHEEL_SLOTS - 1));
+
+    // handlers may arm timers due now (they land in this slot) or cancel
+    // others, so take one at a time.
+    while (_slots[0][slot] != nullptr) {
+        Timer *timer = _slots[0][slot];
+        unlink(timer);
+
+        if (timer->_handler == nullptr) {
+            log_warn("timer w/o handler expired.\n");
+            continue;
+        }
+
+        timer->_handler(timer->_data);
+    }
+}
+
+}
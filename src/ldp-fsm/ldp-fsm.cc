@@ -1,51 +1,73 @@
 #include "utils/log.hh"
 #include "ldp-fsm/ldp-fsm.hh"
 #include "ldp-pdu/ldp-pdu.hh"
+#include "ldp-pdu/ldp-pdu-view.hh"
 #include "ldp-tlv/ldp-tlv.hh"
 
+#include <string.h>
 #include <arpa/inet.h>
 
 namespace ldpd {
 
 const char *LdpSessionStateText[] = {
-    "Invalid", "Initialized", "OpenReceived", "OpenSent", "Operational"
+    "Invalid", "Connecting", "Initialized", "OpenReceived", "OpenSent", "Operational"
 };    
 
-LdpFsm::LdpFsm(Ldpd *ldpd) {
+LdpFsm::LdpFsm(Ldpd *ldpd) : _keepalive_timer(), _hold_timer(), _rx(), _tx() {
     _ldpd = ldpd;
+    _fd = -1;
     _state = Initialized;
     _neighId = 0;
     _neighLs = 0;
     _keep = ldpd->getKeepaliveTime();
+    _max_pdu = ldpd->getMaxPduLength();
     _last_send = 0;
     _last_recv = 0;
+
+    _keepalive_timer.setHandler(LdpFsm::handleKeepaliveTimer, this);
+    _hold_timer.setHandler(LdpFsm::handleHoldTimer, this);
 }
 
 ssize_t LdpFsm::receive(const uint8_t *packet, size_t size) {
-    LdpPdu pdu = LdpPdu();
+    // most pdus on an idle session are a lone keepalive, and all it does is
+    // keep the session up - no need to parse it or look at it any further.
+    if (_state == Operational && isKeepalivePdu(packet, size)) {
+        _last_recv = _ldpd->now();
+        return LDP_KEEPALIVE_PDU_LEN;
+    }
+
+    LdpPduView pdu = LdpPduView();
+    LdpParseError err = LdpParseError();
 
-    ssize_t parsed_len = pdu.parse(packet, size);
+    ssize_t parsed_len = pdu.parse(packet, size, &err);
 
     const char *nei_id_str = inet_ntoa(*(struct in_addr *) &_neighId);
 
     _last_recv = _ldpd->now();
 
     if (parsed_len < 0) {
+        _ldpd->reportParseError(nei_id_str, "pdu", err);
         changeState(LdpSessionState::Invalid);
-        sendNotification(0, 0, LDP_SC_SHUTDOWN);
+        sendNotification(0, 0, ldpParseErrorStatus(err.code));
         return parsed_len;
     }
 
-    for (const LdpMessage *msg : pdu.getMessages()) {
+    for (const LdpMessageView msg : pdu) {
         if (_state == LdpSessionState::Invalid) {
             log_fatal("(%s:%u) this fsm should be deleted and the tcp session should be closed.\n", nei_id_str, _neighLs);
             changeState(LdpSessionState::Invalid);
             return -1;
         }
 
+        if (_state == Connecting) {
+            log_error("(%s:%u) got data before tcp connection is established.\n", nei_id_str, _neighLs);
+            changeState(LdpSessionState::Invalid);
+            return -1;
+        }
+
         if (_state == Initialized) {
-            if (msg->getType() != LDP_MSGTYPE_INITIALIZE) {
-                log_error("(%s:%u) got message of type 0x%.4x in init state.\n", nei_id_str, _neighLs, msg->getType());
+            if (msg.getType() != LDP_MSGTYPE_INITIALIZE) {
+                log_error("(%s:%u) got message of type 0x%.4x in init state.\n", nei_id_str, _neighLs, msg.getType());
                 changeState(LdpSessionState::Invalid);
                 sendNotification(0, 0, LDP_SC_SHUTDOWN);
                 return -1;
@@ -58,9 +80,7 @@ ssize_t LdpFsm::receive(const uint8_t *packet, size_t size) {
                 return -1;
             }
 
-            LdpPdu init = LdpPdu();
-            createInitPdu(init);
-            ssize_t rslt = send(init);
+            ssize_t rslt = sendInit();
 
             if (rslt < 0) {
                 changeState(LdpSessionState::Invalid);
@@ -79,8 +99,8 @@ ssize_t LdpFsm::receive(const uint8_t *packet, size_t size) {
         }
 
         if (_state == OpenReceived) {
-            if (msg->getType() != LDP_MSGTYPE_KEEPALIVE) {
-                log_error("(%s:%u) got message of type 0x%.4x in open-received state.\n", nei_id_str, _neighLs, msg->getType());
+            if (msg.getType() != LDP_MSGTYPE_KEEPALIVE) {
+                log_error("(%s:%u) got message of type 0x%.4x in open-received state.\n", nei_id_str, _neighLs, msg.getType());
                 changeState(LdpSessionState::Invalid);
                 sendNotification(0, 0, LDP_SC_SHUTDOWN);
                 return -1;
@@ -88,12 +108,17 @@ ssize_t LdpFsm::receive(const uint8_t *packet, size_t size) {
 
             _ldpd->handleNewSession(this);
             changeState(LdpSessionState::Operational);
+
+            TimerWheel &timers = _ldpd->getTimerWheel();
+
+            timers.schedule(&_keepalive_timer, _last_send + getKeepaliveInterval());
+            timers.schedule(&_hold_timer, _last_recv + _keep * 1000 + 1);
             continue;
         }
 
         if (_state == OpenSent) {
-            if (msg->getType() != LDP_MSGTYPE_INITIALIZE) {
-                log_error("(%s:%u) got message of type 0x%.4x in open-sent state.\n", nei_id_str, _neighLs, msg->getType());
+            if (msg.getType() != LDP_MSGTYPE_INITIALIZE) {
+                log_error("(%s:%u) got message of type 0x%.4x in open-sent state.\n", nei_id_str, _neighLs, msg.getType());
                 changeState(LdpSessionState::Invalid);
                 sendNotification(0, 0, LDP_SC_SHUTDOWN);
                 return -1;
@@ -116,7 +141,7 @@ ssize_t LdpFsm::receive(const uint8_t *packet, size_t size) {
         }
 
         if (_state == Operational) {
-            if (msg->getType() == LDP_MSGTYPE_KEEPALIVE) {
+            if (msg.getType() == LDP_MSGTYPE_KEEPALIVE) {
                 continue;
             }
 
@@ -138,17 +163,56 @@ ssize_t LdpFsm::receive(const uint8_t *packet, size_t size) {
     return parsed_len;
 }
 
-ssize_t LdpFsm::init(uint32_t neighId, uint16_t neighLabelSpace) {
+/**
+ * @brief test if the buffer starts w/ a pdu holding just a keepalive, by
+ * looking at the pdu and message headers only.
+ *
+ * @param packet start of the pdu.
+ * @param size size of the buffer.
+ * @return true if it does.
+ * @return false if not - the pdu needs a full parse.
+ */
+bool LdpFsm::isKeepalivePdu(const uint8_t *packet, size_t size) {
+    if (size < LDP_KEEPALIVE_PDU_LEN) {
+        return false;
+    }
+
+    // version + pdu length, and message type + message length.
+    uint32_t pdu_hdr, msg_hdr;
+    memcpy(&pdu_hdr, packet, sizeof(pdu_hdr));
+    memcpy(&msg_hdr, packet + LDP_PDU_MIN_LEN, sizeof(msg_hdr));
+
+    return pdu_hdr == htonl((LDP_VERSION << 16) | (LDP_KEEPALIVE_PDU_LEN - LDP_PDU_HDR_LEN)) &&
+        msg_hdr == htonl((LDP_MSGTYPE_KEEPALIVE << 16) | (LDP_MSG_MIN_LEN - LDP_MSG_HDR_LEN));
+}
+
+/**
+ * @brief mark the session as waiting for its (non-blocking) tcp connect to
+ * complete. call init() once connected.
+ * 
+ * @param neighId neighbor lsr-id.
+ * @param neighLabelSpace neighbor label space.
+ */
+void LdpFsm::connecting(uint32_t neighId, uint16_t neighLabelSpace) {
     _neighId = neighId;
     _neighLs = neighLabelSpace;
 
     if (_state != LdpSessionState::Initialized) {
+        return;
+    }
+
+    changeState(LdpSessionState::Connecting);
+}
+
+ssize_t LdpFsm::init(uint32_t neighId, uint16_t neighLabelSpace) {
+    _neighId = neighId;
+    _neighLs = neighLabelSpace;
+
+    if (_state != LdpSessionState::Initialized && _state != LdpSessionState::Connecting) {
         return 0;
     }
 
-    LdpPdu init = LdpPdu();
-    createInitPdu(init);
-    ssize_t rslt = send(init);
+    ssize_t rslt = sendInit();
 
     if (rslt < 0) {
         changeState(LdpSessionState::Invalid);
@@ -180,127 +244,166 @@ uint16_t LdpFsm::getNeighborLabelSpace() const {
     return _neighLs;
 }
 
-ssize_t LdpFsm::send(LdpPdu &pdu) {
-    fillPduHeader(pdu);
+/**
+ * @brief get the max pdu length of the session. until the neighbor's init
+ * message is processed, this is the one we propose.
+ * 
+ * @return uint16_t max pdu length in bytes, header included.
+ */
+uint16_t LdpFsm::getMaxPduLength() const {
+    return _max_pdu;
+}
+
+int LdpFsm::getFd() const {
+    return _fd;
+}
 
-    size_t len = pdu.length();
-    uint8_t *buffer = (uint8_t *) malloc(len);
+void LdpFsm::setFd(int fd) {
+    _fd = fd;
+}
 
-    ssize_t res = pdu.write(buffer, len);
-    if (res < 0) {
-        log_fatal("(%s:%u) failed to write pdu.\n", inet_ntoa(*(struct in_addr *) &_neighId), _neighLs);
-        // send notify?
-        changeState(LdpSessionState::Invalid);
-        return res;
+LdpPduReassembler& LdpFsm::getReceiveBuffer() {
+    return _rx;
+}
+
+LdpPduQueue& LdpFsm::getSendQueue() {
+    return _tx;
+}
+
+/**
+ * @brief start encoding a pdu straight into the send queue. add messages
+ * to the writer, then hand it to send(LdpPduWriter&).
+ * 
+ * note: nothing else may be queued for this session until then.
+ * 
+ * @param writer writer to set up.
+ * @param size max size of the pdu, 0 for the max pdu length of the session.
+ * @return ssize_t bytes written (the pdu header), or -1 on error.
+ */
+ssize_t LdpFsm::beginPdu(LdpPduWriter &writer, size_t size) {
+    if (size == 0) {
+        size = _max_pdu;
     }
 
-    _last_send = _ldpd->now();
+    uint8_t *buffer = _tx.reserve(size);
 
-    res = _ldpd->transmit(this, buffer, len);
-    free(buffer);
+    if (buffer == nullptr) {
+        writer.reset(nullptr, 0);
+        return -1;
+    }
+
+    writer.reset(buffer, size);
 
-    return res;
+    return writer.begin(_ldpd->getRouterId(), _ldpd->getLabelSpace());
 }
 
-void LdpFsm::fillPduHeader(LdpPdu &pdu) const {
-    pdu.setRouterId(_ldpd->getRouterId());
-    pdu.setLabelSpace(_ldpd->getLabelSpace());
-    pdu.recalculateLength();
+/**
+ * @brief finish the pdu started with beginPdu() and queue it.
+ * 
+ * @param writer the writer.
+ * @return ssize_t bytes queued, or -1 on error.
+ */
+ssize_t LdpFsm::send(LdpPduWriter &writer) {
+    ssize_t len = writer.end();
+
+    if (len < 0 || writer.messages() == 0) {
+        log_error("(%s:%u) failed to write pdu.\n", inet_ntoa(*(struct in_addr *) &_neighId), _neighLs);
+        return -1;
+    }
+
+    _tx.commit(len);
+    _last_send = _ldpd->now();
+
+    if (_ldpd->scheduleFlush(this) < 0) {
+        return -1;
+    }
+
+    return len;
 }
 
 ssize_t LdpFsm::sendKeepalive() {
-    LdpPdu pdu = LdpPdu();
-
-    LdpMessage *keep = new LdpMessage();
+    LdpPduWriter writer = LdpPduWriter();
 
-    keep->setType(LDP_MSGTYPE_KEEPALIVE);
-    keep->setId(_ldpd->getNextMessageId());
-    keep->recalculateLength();
+    if (beginPdu(writer) < 0) {
+        return -1;
+    }
 
-    pdu.addMessage(keep);
+    writer.beginMessage(LDP_MSGTYPE_KEEPALIVE, _ldpd->getNextMessageId());
+    writer.endMessage();
 
-    return send(pdu);
+    return send(writer);
 }
 
 ssize_t LdpFsm::sendNotification(uint32_t msgid, uint16_t msgtype, uint32_t code) {
-    LdpPdu pdu = LdpPdu();
-
-    LdpMessage *note = new LdpMessage();
+    LdpPduWriter writer = LdpPduWriter();
 
-    note->setType(LDP_MSGTYPE_NOTIFICATION);
-    note->setId(_ldpd->getNextMessageId());
-    
-    LdpRawTlv *status = new LdpRawTlv();
-    status->setType(LDP_TLVTYPE_STATUS);
+    if (beginPdu(writer) < 0) {
+        return -1;
+    }
 
     LdpStatusTlvValue status_val = LdpStatusTlvValue();
     status_val.setMessageId(msgid);
     status_val.setMessageType(msgtype);
     status_val.setStatusCode(code);
 
-    status->setValue(&status_val);
-
-    note->addTlv(status);
-    note->recalculateLength();
+    writer.beginMessage(LDP_MSGTYPE_NOTIFICATION, _ldpd->getNextMessageId());
+    writer.addTlv(status_val);
+    writer.endMessage();
 
-    pdu.addMessage(note);
-
-    return send(pdu);
+    return send(writer);
 }
 
-void LdpFsm::createInitPdu(LdpPdu &to) {
-    LdpMessage *init = new LdpMessage();
+ssize_t LdpFsm::sendInit() {
+    LdpPduWriter writer = LdpPduWriter();
+
+    if (beginPdu(writer) < 0) {
+        return -1;
+    }
 
-    init->setType(LDP_MSGTYPE_INITIALIZE);
-    init->setId(_ldpd->getNextMessageId());
-    
     LdpCommonSessionParamsTlvValue session = LdpCommonSessionParamsTlvValue();
 
     session.setReceiverLabelSpace(_neighLs);
     session.setReceiverRouterId(_neighId);
     session.setKeepaliveTime(_ldpd->getKeepaliveTime());
+    session.setMaxPduLength(_ldpd->getMaxPduLength());
 
-    LdpRawTlv *tlv = new LdpRawTlv();
-    tlv->setValue(&session);
-
-    init->addTlv(tlv);
-    init->recalculateLength();
-
-    to.addMessage(init);
+    writer.beginMessage(LDP_MSGTYPE_INITIALIZE, _ldpd->getNextMessageId());
+    writer.addTlv(session);
+    writer.endMessage();
 
-    fillPduHeader(to);
+    return send(writer);
 }
 
-int LdpFsm::processInit(const LdpMessage *init) {
-    const LdpRawTlv *session = init->getTlv(LDP_TLVTYPE_COMMON_SESSION);
+int LdpFsm::processInit(const LdpMessageView &init) {
+    LdpTlvView session = init.getTlv(LDP_TLVTYPE_COMMON_SESSION);
     const char *nei_id_str = inet_ntoa(*(struct in_addr *) &(_neighId));
 
-    if (session == nullptr) {
-        sendNotification(init->getId(), 0, LDP_SC_MISSING_MSG_PARAM);
+    if (!session.valid()) {
+        sendNotification(init.getId(), 0, LDP_SC_MISSING_MSG_PARAM);
         log_error("(%s:%u) common session params tlv not found in init msg.\n", nei_id_str, _neighLs);
         return -1;
     }
 
-    LdpCommonSessionParamsTlvValue *params = (LdpCommonSessionParamsTlvValue  *) session->getParsedValue();
+    LdpCommonSessionParamsTlvValue params = LdpCommonSessionParamsTlvValue();
 
-    if (params == nullptr) {
-        sendNotification(init->getId(), 0, LDP_SC_MALFORMED_TLV_VAL);
+    if (session.parseValue(params) < 0) {
+        sendNotification(init.getId(), 0, LDP_SC_MALFORMED_TLV_VAL);
         log_error("(%s:%u) cannot understand common session param tlv value.\n", nei_id_str, _neighLs);
         return -1;
     }
 
-    if (params->loopDetection()) { // todo
+    if (params.loopDetection()) { // todo
         changeState(LdpSessionState::Invalid);
-        sendNotification(init->getId(), params->getType(), LDP_SC_INTERNAL_ERROR);
+        sendNotification(init.getId(), params.getType(), LDP_SC_INTERNAL_ERROR);
         log_error("loop detection not yet implemented.\n");
         return -1;
     }
 
-    uint16_t keep = params->getKeepaliveTime();
+    uint16_t keep = params.getKeepaliveTime();
 
     if (keep == 0) {
         changeState(LdpSessionState::Invalid);
-        sendNotification(init->getId(), params->getType(), LDP_SC_BAD_KEEPALIVE);
+        sendNotification(init.getId(), params.getType(), LDP_SC_BAD_KEEPALIVE);
         log_error("(%s:%u) sent a invalid keepalive timer.\n", nei_id_str, _neighLs);
         return -1;
     }
@@ -309,34 +412,75 @@ int LdpFsm::processInit(const LdpMessage *init) {
         _keep = keep;
     }
 
-    uint32_t id = params->getReceiverRouterId();
-    uint32_t space = params->getReceiverLabelSpace();
+    uint16_t max_pdu = params.getMaxPduLength();
 
-    delete params;
+    if (max_pdu <= LDP_MAX_PDU_LEN_USE_DEF) {
+        max_pdu = LDP_DEF_MAX_PDU_LEN;
+    }
+
+    if (_max_pdu > max_pdu) {
+        _max_pdu = max_pdu;
+    }
+
+    uint32_t id = params.getReceiverRouterId();
+    uint32_t space = params.getReceiverLabelSpace();
 
     if (id != _ldpd->getRouterId() || space != _ldpd->getLabelSpace()) {
         changeState(LdpSessionState::Invalid);
-        sendNotification(init->getId(), 0, LDP_SC_SESSION_REJ_NOHELLO);
+        sendNotification(init.getId(), 0, LDP_SC_SESSION_REJ_NOHELLO);
         log_error("(%s:%u) target is not us.\n", nei_id_str, _neighLs);
         return -1;
     }
 
-    log_debug("(%s:%u) session params: keep = %u.\n", nei_id_str, _neighLs, _keep);
+    log_debug("(%s:%u) session params: keep = %u, max pdu = %u.\n", nei_id_str, _neighLs, _keep, _max_pdu);
 
     return 0;
 }
 
-void LdpFsm::tick() {
-    if (_state == LdpSessionState::Operational) {
-        if ((_ldpd->now() - _last_send) > _keep - 10) {
-            sendKeepalive();
-        }
+void LdpFsm::handleKeepaliveTimer(void *self) {
+    LdpFsm *fsm = (LdpFsm *) self;
+    uint32_t interval = fsm->getKeepaliveInterval();
 
-        if ((_ldpd->now() - _last_recv) > _keep) {
-            log_error("(%s:%u) hold timer expired.\n", inet_ntoa(*(struct in_addr *) &_neighId), _neighLs);
-            _ldpd->shutdownSession(this, LDP_SC_KEEPALIVE_EXPIRED);
-        }
+    uint64_t now = fsm->_ldpd->now();
+
+    if (now - fsm->_last_send >= interval && fsm->sendKeepalive() < 0) {
+        log_warn("(%s:%u) failed to send keepalive, will retry.\n", inet_ntoa(*(struct in_addr *) &fsm->_neighId), fsm->_neighLs);
+    }
+
+    uint64_t next = fsm->_last_send + interval;
+
+    // nothing was sent (_last_send not moved) - never re-arm at a time that
+    // is already due, the wheel would run us again right away, forever.
+    if (next <= now) {
+        next = now + interval;
     }
+
+    fsm->_ldpd->getTimerWheel().schedule(&fsm->_keepalive_timer, next);
+}
+
+void LdpFsm::handleHoldTimer(void *self) {
+    LdpFsm *fsm = (LdpFsm *) self;
+
+    if (fsm->_ldpd->now() - fsm->_last_recv <= (uint64_t) fsm->_keep * 1000) {
+        fsm->_ldpd->getTimerWheel().schedule(&fsm->_hold_timer, fsm->_last_recv + fsm->_keep * 1000 + 1);
+        return;
+    }
+
+    log_error("(%s:%u) hold timer expired.\n", inet_ntoa(*(struct in_addr *) &fsm->_neighId), fsm->_neighLs);
+
+    // fsm is deleted after this.
+    fsm->_ldpd->shutdownSession(fsm, LDP_SC_KEEPALIVE_EXPIRED);
+    fsm->_ldpd->removeSession(fsm);
+}
+
+/**
+ * @brief get the time of silence after which we send a keepalive: a third
+ * of the negotiated hold time, so two can get lost w/o the peer timing out.
+ * 
+ * @return uint32_t ms.
+ */
+uint32_t LdpFsm::getKeepaliveInterval() const {
+    return _keep * 1000 / 3;
 }
 
 void LdpFsm::changeState(LdpSessionState newState) {
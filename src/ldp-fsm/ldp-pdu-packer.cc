@@ -0,0 +1,118 @@
+#include "utils/log.hh"
+#include "ldp-fsm/ldp-pdu-packer.hh"
+#include "ldp-fsm/ldp-fsm.hh"
+
+namespace ldpd {
+
+LdpPduPacker::LdpPduPacker(LdpFsm *session) : _writer() {
+    _session = session;
+    _open = false;
+    _pdus = 0;
+    _messages = 0;
+}
+
+/**
+ * @brief note: a pdu not flushed is dropped.
+ */
+LdpPduPacker::~LdpPduPacker() {
+    if (_open && _writer.messages() > 0) {
+        log_warn("%zu message(s) not flushed, dropped.\n", _writer.messages());
+    }
+}
+
+/**
+ * @brief add a message.
+ *
+ * @param encoder called to write the message - maybe twice, if the message
+ * does not fit in the open pdu.
+ * @param data passed to the encoder.
+ * @return ssize_t size of the message, or -1 on error (the message does not
+ * fit in an empty pdu, or the pdu can't be queued).
+ */
+ssize_t LdpPduPacker::add(LdpMessageEncoder encoder, void *data) {
+    if (!_open) {
+        if (_session->beginPdu(_writer) < 0) {
+            return -1;
+        }
+
+        _open = true;
+    }
+
+    ssize_t len = encoder(data, _writer);
+
+    if (len >= 0) {
+        ++_messages;
+        return len;
+    }
+
+    _writer.rollbackMessage();
+
+    if (_writer.messages() == 0) {
+        log_error("message does not fit in a pdu of %u bytes.\n", _session->getMaxPduLength());
+        return -1;
+    }
+
+    if (flush() < 0 || _session->beginPdu(_writer) < 0) {
+        return -1;
+    }
+
+    _open = true;
+
+    len = encoder(data, _writer);
+
+    if (len < 0) {
+        _writer.rollbackMessage();
+        log_error("message does not fit in a pdu of %u bytes.\n", _session->getMaxPduLength());
+        return -1;
+    }
+
+    ++_messages;
+
+    return len;
+}
+
+/**
+ * @brief queue the open pdu, if it has any message in it.
+ *
+ * @return ssize_t bytes queued, or -1 on error.
+ */
+ssize_t LdpPduPacker::flush() {
+    if (!_open) {
+        return 0;
+    }
+
+    _open = false;
+
+    if (_writer.messages() == 0) {
+        return 0;
+    }
+
+    ssize_t len = _session->send(_writer);
+
+    if (len < 0) {
+        return -1;
+    }
+
+    ++_pdus;
+
+    return len;
+}
+
+/**
+ * @brief get size of the open pdu.
+ *
+ * @return size_t bytes, 0 if no pdu is open.
+ */
+size_t LdpPduPacker::length() const {
+    return _open ? _writer.length() : 0;
+}
+
+size_t LdpPduPacker::pdus() const {
+    return _pdus;
+}
+
+size_t LdpPduPacker::messages() const {
+    return _messages;
+}
+
+}
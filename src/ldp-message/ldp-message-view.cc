@@ -0,0 +1,194 @@
+#include "ldp-message/ldp-message-view.hh"
+#include "ldp-pdu/ldp-parse-error.hh"
+
+#include <string.h>
+#include <arpa/inet.h>
+
+namespace ldpd {
+
+LdpMessageView::LdpMessageView() {
+    _msg = nullptr;
+    _len = 0;
+}
+
+/**
+ * @brief make a view of a message that is already known to be valid.
+ *
+ * @param msg start of the message (the type field).
+ * @param len size of the entire message.
+ */
+LdpMessageView::LdpMessageView(const uint8_t *msg, size_t len) {
+    _msg = msg;
+    _len = len;
+}
+
+/**
+ * @brief check the message at the start of the buffer and point the view at
+ * it.
+ *
+ * @param from source buffer.
+ * @param buf_sz source buffer size.
+ * @param err if not nullptr, set to what went wrong (and where) on error.
+ * @return ssize_t size of the message (header included), or -1 on error.
+ */
+ssize_t LdpMessageView::parse(const uint8_t *from, size_t buf_sz, LdpParseError *err) {
+    if (buf_sz < LDP_MSG_MIN_LEN) {
+        LDP_PARSE_FAIL(err, ParseBadMessageLength, 0);
+    }
+
+    uint16_t msg_len;
+    memcpy(&msg_len, from + sizeof(uint16_t), sizeof(msg_len));
+    msg_len = ntohs(msg_len);
+
+    if (msg_len > buf_sz - LDP_MSG_HDR_LEN) {
+        LDP_PARSE_FAIL(err, ParseBadMessageLength, sizeof(uint16_t));
+    }
+
+    if (msg_len < sizeof(uint32_t)) {
+        LDP_PARSE_FAIL(err, ParseBadMessageLength, sizeof(uint16_t));
+    }
+
+    const uint8_t *ptr = from + LDP_MSG_MIN_LEN;
+    size_t tlvs_len = msg_len - sizeof(uint32_t);
+
+    while (tlvs_len > 0) {
+        if (tlvs_len < LDP_TLV_HDR_LEN) {
+            LDP_PARSE_FAIL(err, ParseBadTlvLength, ptr - from);
+        }
+
+        uint16_t tlv_len;
+        memcpy(&tlv_len, ptr + sizeof(uint16_t), sizeof(tlv_len));
+        tlv_len = ntohs(tlv_len);
+
+        if (tlv_len > tlvs_len - LDP_TLV_HDR_LEN) {
+            LDP_PARSE_FAIL(err, ParseBadTlvLength, ptr - from + sizeof(uint16_t));
+        }
+
+        ptr += LDP_TLV_HDR_LEN + tlv_len;
+        tlvs_len -= LDP_TLV_HDR_LEN + tlv_len;
+    }
+
+    _msg = from;
+    _len = LDP_MSG_HDR_LEN + msg_len;
+
+    return _len;
+}
+
+/**
+ * @brief test if the unknown bit is set in the type field.
+ *
+ * @return true if set.
+ * @return false if not set.
+ */
+bool LdpMessageView::unknown() const {
+    return _msg != nullptr && (_msg[0] & 0b10000000);
+}
+
+/**
+ * @brief get message type.
+ *
+ * @return uint16_t type in host byte order, w/o the unknown bit.
+ */
+uint16_t LdpMessageView::getType() const {
+    if (_msg == nullptr) {
+        return 0;
+    }
+
+    uint16_t type;
+    memcpy(&type, _msg, sizeof(type));
+
+    return ntohs(type) & 0b0111111111111111;
+}
+
+uint16_t LdpMessageView::getLength() const {
+    return _msg == nullptr ? 0 : _len - LDP_MSG_HDR_LEN;
+}
+
+uint32_t LdpMessageView::getId() const {
+    if (_msg == nullptr) {
+        return 0;
+    }
+
+    uint32_t id;
+    memcpy(&id, _msg + LDP_MSG_HDR_LEN, sizeof(id));
+
+    return ntohl(id);
+}
+
+/**
+ * @brief get the entire message, header included.
+ *
+ * @return const uint8_t* message, size() bytes.
+ */
+const uint8_t* LdpMessageView::data() const {
+    return _msg;
+}
+
+size_t LdpMessageView::size() const {
+    return _len;
+}
+
+LdpTlvIterator LdpMessageView::begin() const {
+    if (_msg == nullptr) {
+        return LdpTlvIterator(nullptr, nullptr);
+    }
+
+    return LdpTlvIterator(_msg + LDP_MSG_MIN_LEN, _msg + _len);
+}
+
+LdpTlvIterator LdpMessageView::end() const {
+    if (_msg == nullptr) {
+        return LdpTlvIterator(nullptr, nullptr);
+    }
+
+    return LdpTlvIterator(_msg + _len, _msg + _len);
+}
+
+/**
+ * @brief find the first tlv of the given type.
+ *
+ * @param type tlv type.
+ * @return LdpTlvView the tlv, or an invalid view if not found.
+ */
+LdpTlvView LdpMessageView::getTlv(uint16_t type) const {
+    for (LdpTlvIterator it = begin(); it != end(); ++it) {
+        LdpTlvView tlv = *it;
+
+        if (tlv.getType() == type) {
+            return tlv;
+        }
+    }
+
+    return LdpTlvView();
+}
+
+LdpMessageIterator::LdpMessageIterator(const uint8_t *at, const uint8_t *end) {
+    _at = at;
+    _end = end;
+}
+
+LdpMessageView LdpMessageIterator::operator*() const {
+    uint16_t len;
+    memcpy(&len, _at + sizeof(uint16_t), sizeof(len));
+
+    return LdpMessageView(_at, LDP_MSG_HDR_LEN + ntohs(len));
+}
+
+LdpMessageIterator& LdpMessageIterator::operator++() {
+    uint16_t len;
+    memcpy(&len, _at + sizeof(uint16_t), sizeof(len));
+
+    _at += LDP_MSG_HDR_LEN + ntohs(len);
+
+    if (_at > _end) {
+        _at = _end;
+    }
+
+    return *this;
+}
+
+bool LdpMessageIterator::operator!=(const LdpMessageIterator &other) const {
+    return _at != other._at;
+}
+
+}
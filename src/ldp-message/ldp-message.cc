@@ -3,14 +3,23 @@
 #include "ldp-message/ldp-message.hh"
 
 #include <arpa/inet.h>
+#include <algorithm>
 
 namespace ldpd {
 
-LdpMessage::LdpMessage() : _tlvs() {
+/**
+ * @brief create a message.
+ * 
+ * @param arena arena to allocate the tlvs parsed into this message from.
+ * nullptr to use the heap.
+ */
+LdpMessage::LdpMessage(Arena *arena) : _tlvs(ArenaAllocator<LdpRawTlv *>(arena)), _index(ArenaAllocator<LdpTlvIndexEntry>(arena)) {
     _type = 0;
     _length = 0;
     _id = 0;
     _unknown = false;
+    _arena = arena;
+    _indexed = false;
 }
 
 LdpMessage::~LdpMessage() {
@@ -60,6 +69,7 @@ ssize_t LdpMessage::setUnknown(bool unknown) {
 
 ssize_t LdpMessage::addTlv(LdpRawTlv *message) {
     _tlvs.push_back(message);
+    _indexed = false;
 
     return message->length();
 }
@@ -70,6 +80,8 @@ void LdpMessage::clearTlvs() {
     }
 
     _tlvs.clear();
+    _index.clear();
+    _indexed = false;
 }
 
 uint16_t LdpMessage::recalculateLength() {
@@ -85,49 +97,104 @@ uint16_t LdpMessage::recalculateLength() {
 }
 
 const std::vector<LdpRawTlv *> LdpMessage::getTlvs() const {
-    return _tlvs;
+    return std::vector<LdpRawTlv *>(_tlvs.begin(), _tlvs.end());
+}
+
+/**
+ * @brief get the first tlv of the given type.
+ * 
+ * note: the lookup goes through an index of the tlv types. if the type of a
+ * tlv is changed after it was added, call getTlv only after that.
+ * 
+ * @param type tlv type.
+ * @return const LdpRawTlv* tlv, or nullptr if not found.
+ */
+const LdpRawTlv* LdpMessage::getTlv(uint16_t type) const {
+    if (!_indexed) {
+        buildIndex();
+    }
+
+    LdpTlvIndexEntry key;
+    key.type = type;
+    key.tlv = nullptr;
+
+    auto it = std::lower_bound(_index.begin(), _index.end(), key, [](const LdpTlvIndexEntry &a, const LdpTlvIndexEntry &b) {
+        return a.type < b.type;
+    });
+
+    if (it == _index.end() || it->type != type) {
+        return nullptr;
+    }
+
+    return it->tlv;
 }
 
-const LdpRawTlv* LdpMessage::getTlv(uint16_t type) const {
+void LdpMessage::buildIndex() const {
+    _index.clear();
+
     for (LdpRawTlv *tlv : _tlvs) {
-        if (tlv->getType() == type) {
-            return tlv;
-        }
+        LdpTlvIndexEntry entry;
+        entry.type = tlv->getType();
+        entry.tlv = tlv;
+
+        _index.push_back(entry);
     }
 
-    return nullptr;
+    // stable, so the first tlv of a type comes first.
+    std::stable_sort(_index.begin(), _index.end(), [](const LdpTlvIndexEntry &a, const LdpTlvIndexEntry &b) {
+        return a.type < b.type;
+    });
+
+    _indexed = true;
 }
 
+/**
+ * @brief parse a message from buffer. the message is checked in full before
+ * anything is built.
+ * 
+ * @param from source buffer.
+ * @param buf_sz source buffer size.
+ * @return ssize_t bytes parsed, or -1 on error.
+ */
 ssize_t LdpMessage::parse(const uint8_t *from, size_t buf_sz) {
-    const uint8_t *buffer = from;
-    size_t buf_remaining = buf_sz;
+    LdpMessageView msg = LdpMessageView();
 
-    GETVAL_S(buffer, buf_remaining, uint16_t, _type, ntohs, -1);
-    GETVAL_S(buffer, buf_remaining, uint16_t, _length, ntohs, -1);
-
-    size_t msg_len = _length;
-    
-    if (msg_len > buf_remaining) {
-        log_fatal("msg_len (%zu) greater then remaining buffer (%zu), packet truncated?\n", msg_len, buf_remaining);
+    if (msg.parse(from, buf_sz) < 0) {
         return -1;
     }
 
-    GETVAL_S(buffer, msg_len, uint32_t, _id, ntohl, -1);
+    return parse(msg);
+}
 
-    if (_type & 0b1000000000000000) {
-        _unknown = true;
-        _type &= 0b0111111111111111;
-    }
+/**
+ * @brief build the message from one that was already checked (see
+ * LdpMessageView::parse) - no further checks are done.
+ * 
+ * @param msg the message.
+ * @return ssize_t bytes parsed, or -1 on error.
+ */
+ssize_t LdpMessage::parse(const LdpMessageView &msg) {
+    clearTlvs();
+
+    _type = msg.getType();
+    _unknown = msg.unknown();
+    _length = msg.getLength();
+    _id = msg.getId();
 
-    while (msg_len > 0) {
-        LdpRawTlv *tlv = new LdpRawTlv();
+    for (const LdpTlvView tlv : msg) {
+        LdpRawTlv *raw = new (_arena) LdpRawTlv(_arena);
 
-        PARSE_S(buffer, msg_len, tlv, -1, true);
+        if (raw->parse(tlv) < 0) {
+            delete raw;
+            return -1;
+        }
 
-        this->addTlv(tlv);
+        this->addTlv(raw);
     }
 
-    return buffer - from;
+    buildIndex();
+
+    return msg.size();
 }
 
 ssize_t LdpMessage::write(uint8_t *to, size_t buf_sz) const {
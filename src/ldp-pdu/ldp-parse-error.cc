@@ -0,0 +1,49 @@
+#include "ldp-pdu/ldp-parse-error.hh"
+#include "ldp-tlv/ldp-status-tlv-value.hh"
+
+namespace ldpd {
+
+const char *LdpParseErrorText[] = {
+    "no error", "bad protocol version", "bad pdu length", "bad message length", "bad tlv length",
+    "unknown tlv", "unknown fec", "unsupported address family", "malformed tlv value"
+};
+
+const uint32_t LdpParseErrorStatus[] = {
+    LDP_SC_SUCCESS, LDP_SC_BAD_PROTO_VER, LDP_SC_BAD_PDU_LEN, LDP_SC_BAD_MSG_LEN, LDP_SC_BAD_TLV_LEN,
+    LDP_SC_UNKNOWN_TLV, LDP_SC_UNKNOWN_FEC, LDP_SC_UNSUPPORTED_AF, LDP_SC_MALFORMED_TLV_VAL
+};
+
+LdpParseError::LdpParseError() {
+    code = ParseOk;
+    offset = 0;
+}
+
+void LdpParseError::set(LdpParseErrorCode code, size_t offset) {
+    this->code = code;
+    this->offset = offset;
+}
+
+/**
+ * @brief get the status code (rfc 5036, section 3.9) to send to the neighbor
+ * for a parse error.
+ *
+ * @param code parse error.
+ * @return uint32_t status code, w/o the e/f bits.
+ */
+uint32_t ldpParseErrorStatus(LdpParseErrorCode code) {
+    if (code > ParseMalformedValue) {
+        return LDP_SC_INTERNAL_ERROR;
+    }
+
+    return LdpParseErrorStatus[code];
+}
+
+const char* ldpParseErrorText(LdpParseErrorCode code) {
+    if (code > ParseMalformedValue) {
+        return "unknown error";
+    }
+
+    return LdpParseErrorText[code];
+}
+
+}
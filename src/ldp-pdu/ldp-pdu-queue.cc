@@ -0,0 +1,227 @@
+#include "utils/log.hh"
+#include "ldp-pdu/ldp-pdu-queue.hh"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/uio.h>
+
+namespace ldpd {
+
+LdpPduQueue::LdpPduQueue() : _chunks() {
+    memset(&_spare, 0, sizeof(_spare));
+    _pending = 0;
+    _congested = false;
+}
+
+LdpPduQueue::~LdpPduQueue() {
+    clear();
+
+    if (_spare.data != nullptr) {
+        free(_spare.data);
+    }
+}
+
+/**
+ * @brief queue a copy of the given buffer.
+ *
+ * @param buffer data.
+ * @param len data length.
+ * @return ssize_t bytes queued, or -1 if out of memory.
+ */
+ssize_t LdpPduQueue::push(const uint8_t *buffer, size_t len) {
+    uint8_t *to = reserve(len);
+
+    if (to == nullptr) {
+        return -1;
+    }
+
+    memcpy(to, buffer, len);
+    commit(len);
+
+    return len;
+}
+
+/**
+ * @brief get contiguous space for len bytes at the end of the queue. the
+ * space is not part of the queue until commit() is called.
+ *
+ * @param len bytes needed.
+ * @return uint8_t* where to write, or nullptr if out of memory.
+ */
+uint8_t* LdpPduQueue::reserve(size_t len) {
+    if (_chunks.size() > 0) {
+        LdpPduQueueChunk &last = _chunks.back();
+
+        if (last.size - last.tail >= len) {
+            return last.data + last.tail;
+        }
+    }
+
+    LdpPduQueueChunk chunk;
+
+    if (_spare.data != nullptr && _spare.size >= len) {
+        chunk = _spare;
+        memset(&_spare, 0, sizeof(_spare));
+    } else {
+        chunk.size = len > LDP_TXQ_CHUNK_SIZE ? len : LDP_TXQ_CHUNK_SIZE;
+        chunk.data = (uint8_t *) malloc(chunk.size);
+
+        if (chunk.data == nullptr) {
+            log_error("malloc(): can not allocate %zu bytes for output queue.\n", chunk.size);
+            return nullptr;
+        }
+    }
+
+    chunk.head = 0;
+    chunk.tail = 0;
+
+    _chunks.push_back(chunk);
+
+    return chunk.data;
+}
+
+/**
+ * @brief add len bytes written to the space returned by reserve() to the
+ * queue.
+ *
+ * @param len bytes written.
+ */
+void LdpPduQueue::commit(size_t len) {
+    if (_chunks.size() == 0) {
+        log_error("commit of %zu bytes w/o reserve.\n", len);
+        return;
+    }
+
+    LdpPduQueueChunk &last = _chunks.back();
+
+    if (len > last.size - last.tail) {
+        log_error("commit of %zu bytes but only %zu reserved.\n", len, last.size - last.tail);
+        len = last.size - last.tail;
+    }
+
+    last.tail += len;
+    _pending += len;
+
+    updateCongestion();
+}
+
+/**
+ * @brief write queued data to fd until the queue is empty or the socket
+ * would block.
+ *
+ * @param fd non-blocking socket.
+ * @return ssize_t bytes written, or -1 on error (errno is set).
+ */
+ssize_t LdpPduQueue::flush(int fd) {
+    struct iovec iov[LDP_TXQ_IOV_MAX];
+    ssize_t total = 0;
+
+    while (_pending > 0) {
+        int iovcnt = 0;
+
+        for (const LdpPduQueueChunk &chunk : _chunks) {
+            if (iovcnt == LDP_TXQ_IOV_MAX) {
+                break;
+            }
+
+            if (chunk.tail == chunk.head) {
+                continue;
+            }
+
+            iov[iovcnt].iov_base = chunk.data + chunk.head;
+            iov[iovcnt].iov_len = chunk.tail - chunk.head;
+            ++iovcnt;
+        }
+
+        ssize_t len = writev(fd, iov, iovcnt);
+
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+
+            return -1;
+        }
+
+        total += len;
+        _pending -= len;
+
+        size_t left = (size_t) len;
+
+        while (_chunks.size() > 0) {
+            LdpPduQueueChunk &first = _chunks.front();
+            size_t in_chunk = first.tail - first.head;
+
+            if (left < in_chunk) {
+                first.head += left;
+                break;
+            }
+
+            left -= in_chunk;
+
+            // keep the last chunk for further appends.
+            if (_chunks.size() == 1) {
+                first.head = 0;
+                first.tail = 0;
+                break;
+            }
+
+            if (_spare.data == nullptr) {
+                _spare = first;
+            } else {
+                free(first.data);
+            }
+
+            _chunks.pop_front();
+        }
+    }
+
+    updateCongestion();
+
+    return total;
+}
+
+/**
+ * @brief get number of bytes queued and not yet written.
+ *
+ * @return size_t bytes.
+ */
+size_t LdpPduQueue::pending() const {
+    return _pending;
+}
+
+/**
+ * @brief check if the peer is not keeping up. producers of bulk data (label
+ * mappings) should hold off while this is true.
+ *
+ * @return true if queue went above the high watermark and has not yet
+ * drained below the low watermark.
+ */
+bool LdpPduQueue::congested() const {
+    return _congested;
+}
+
+void LdpPduQueue::clear() {
+    for (LdpPduQueueChunk &chunk : _chunks) {
+        free(chunk.data);
+    }
+
+    _chunks.clear();
+    _pending = 0;
+    _congested = false;
+}
+
+void LdpPduQueue::updateCongestion() {
+    if (_pending >= LDP_TXQ_HIGH_WATERMARK) {
+        _congested = true;
+    } else if (_pending <= LDP_TXQ_LOW_WATERMARK) {
+        _congested = false;
+    }
+}
+
+}
@@ -0,0 +1,159 @@
+#include "utils/log.hh"
+#include "ldp-pdu/ldp-pdu-reassembler.hh"
+
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+namespace ldpd {
+
+LdpPduReassembler::LdpPduReassembler() {
+    _buffer = nullptr;
+    _size = 0;
+    _head = 0;
+    _tail = 0;
+    _want = LDP_REASM_INIT_SIZE;
+}
+
+LdpPduReassembler::~LdpPduReassembler() {
+    if (_buffer != nullptr) {
+        free(_buffer);
+    }
+}
+
+/**
+ * @brief get space to read into.
+ *
+ * note: this may move the unread data around. pointers returned by next()
+ * are not valid anymore after calling this.
+ *
+ * @param avail set to the number of bytes that can be written.
+ * @return uint8_t* where to write, or nullptr if out of memory.
+ */
+uint8_t* LdpPduReassembler::prepare(size_t &avail) {
+    if (_want > _size && !grow(_want)) {
+        avail = 0;
+        return nullptr;
+    }
+
+    if (_size - _tail < LDP_REASM_MIN_READ || _head == _tail) {
+        compact();
+    }
+
+    avail = _size - _tail;
+
+    return _buffer + _tail;
+}
+
+/**
+ * @brief mark bytes written to the space returned by prepare() as valid.
+ *
+ * @param len bytes written.
+ */
+void LdpPduReassembler::commit(size_t len) {
+    if (len > _size - _tail) {
+        log_error("commit of %zu bytes but only %zu available.\n", len, _size - _tail);
+        len = _size - _tail;
+    }
+
+    // read filled all the space we had - peer is probably sending a lot,
+    // give the next read more room.
+    if (len == _size - _tail && _size < LDP_REASM_MAX_SIZE) {
+        _want = _size * 2 > LDP_REASM_MAX_SIZE ? LDP_REASM_MAX_SIZE : _size * 2;
+    }
+
+    _tail += len;
+}
+
+/**
+ * @brief get the next complete pdu.
+ *
+ * note: the returned pointer points into the internal buffer and is valid
+ * until the next call to prepare() or clear().
+ *
+ * @param pdu set to the start of the pdu.
+ * @param len set to the total length of the pdu (header included).
+ * @return int LDP_REASM_PDU if a pdu is returned, LDP_REASM_NEED_MORE if
+ * there is no complete pdu buffered, or LDP_REASM_BAD_LENGTH if the length
+ * field can not be valid (stream can not be re-synchronized).
+ */
+int LdpPduReassembler::next(const uint8_t* &pdu, size_t &len) {
+    size_t buffered = _tail - _head;
+
+    if (buffered < LDP_PDU_HDR_LEN) {
+        return LDP_REASM_NEED_MORE;
+    }
+
+    uint16_t pdu_len;
+    memcpy(&pdu_len, _buffer + _head + sizeof(uint16_t), sizeof(pdu_len));
+
+    size_t tot_len = ntohs(pdu_len) + LDP_PDU_HDR_LEN;
+
+    if (tot_len < LDP_PDU_MIN_LEN) {
+        return LDP_REASM_BAD_LENGTH;
+    }
+
+    if (tot_len > buffered) {
+        if (tot_len > _size) {
+            _want = tot_len;
+        }
+
+        return LDP_REASM_NEED_MORE;
+    }
+
+    pdu = _buffer + _head;
+    len = tot_len;
+
+    _head += tot_len;
+
+    return LDP_REASM_PDU;
+}
+
+/**
+ * @brief get number of buffered bytes not yet returned by next().
+ *
+ * @return size_t bytes.
+ */
+size_t LdpPduReassembler::pending() const {
+    return _tail - _head;
+}
+
+size_t LdpPduReassembler::capacity() const {
+    return _size;
+}
+
+void LdpPduReassembler::clear() {
+    _head = 0;
+    _tail = 0;
+}
+
+void LdpPduReassembler::compact() {
+    if (_head == 0) {
+        return;
+    }
+
+    size_t buffered = _tail - _head;
+
+    if (buffered > 0) {
+        memmove(_buffer, _buffer + _head, buffered);
+    }
+
+    _head = 0;
+    _tail = buffered;
+}
+
+bool LdpPduReassembler::grow(size_t size) {
+    uint8_t *buffer = (uint8_t *) realloc(_buffer, size);
+
+    if (buffer == nullptr) {
+        log_error("realloc(): can not grow reassembly buffer to %zu bytes.\n", size);
+        return false;
+    }
+
+    _buffer = buffer;
+    _size = size;
+
+    return true;
+}
+
+}
@@ -0,0 +1,145 @@
+#include "ldp-pdu/ldp-pdu-view.hh"
+#include "ldp-pdu/ldp-parse-error.hh"
+
+#include <string.h>
+#include <arpa/inet.h>
+
+namespace ldpd {
+
+LdpPduView::LdpPduView() {
+    _pdu = nullptr;
+    _len = 0;
+}
+
+/**
+ * @brief check the pdu at the start of the buffer and point the view at it.
+ *
+ * @param from source buffer.
+ * @param buf_sz source buffer size.
+ * @param err if not nullptr, set to what went wrong (and where) on error.
+ * @return ssize_t size of the pdu (header included), or -1 on error.
+ */
+ssize_t LdpPduView::parse(const uint8_t *from, size_t buf_sz, LdpParseError *err) {
+    if (buf_sz < LDP_PDU_MIN_LEN) {
+        LDP_PARSE_FAIL(err, ParseBadPduLength, 0);
+    }
+
+    uint16_t version, pdu_len;
+    memcpy(&version, from, sizeof(version));
+    memcpy(&pdu_len, from + sizeof(uint16_t), sizeof(pdu_len));
+    version = ntohs(version);
+    pdu_len = ntohs(pdu_len);
+
+    if (version != LDP_VERSION) {
+        LDP_PARSE_FAIL(err, ParseBadVersion, 0);
+    }
+
+    if (pdu_len < LDP_PDU_MIN_LEN - LDP_PDU_HDR_LEN) {
+        LDP_PARSE_FAIL(err, ParseBadPduLength, sizeof(uint16_t));
+    }
+
+    if (pdu_len > buf_sz - LDP_PDU_HDR_LEN) {
+        LDP_PARSE_FAIL(err, ParseBadPduLength, sizeof(uint16_t));
+    }
+
+    const uint8_t *ptr = from + LDP_PDU_MIN_LEN;
+    size_t msgs_len = pdu_len - (LDP_PDU_MIN_LEN - LDP_PDU_HDR_LEN);
+
+    while (msgs_len > 0) {
+        LdpMessageView msg = LdpMessageView();
+
+        ssize_t ret = msg.parse(ptr, msgs_len, err);
+
+        if (ret < 0) {
+            if (err != nullptr) {
+                err->offset += ptr - from;
+            }
+
+            return -1;
+        }
+
+        ptr += ret;
+        msgs_len -= ret;
+    }
+
+    _pdu = from;
+    _len = LDP_PDU_HDR_LEN + pdu_len;
+
+    return _len;
+}
+
+uint16_t LdpPduView::getVersion() const {
+    return _pdu == nullptr ? 0 : LDP_VERSION;
+}
+
+/**
+ * @brief get length field in the pdu.
+ *
+ * @return uint16_t length in host byte.
+ */
+uint16_t LdpPduView::getLength() const {
+    return _pdu == nullptr ? 0 : _len - LDP_PDU_HDR_LEN;
+}
+
+/**
+ * @brief get router id field in the pdu.
+ *
+ * @return uint32_t router id in network byte.
+ */
+uint32_t LdpPduView::getRouterId() const {
+    if (_pdu == nullptr) {
+        return 0;
+    }
+
+    uint32_t id;
+    memcpy(&id, _pdu + LDP_PDU_HDR_LEN, sizeof(id));
+
+    return id;
+}
+
+/**
+ * @brief get label space field in the pdu.
+ *
+ * @return uint16_t label space in host byte.
+ */
+uint16_t LdpPduView::getLabelSpace() const {
+    if (_pdu == nullptr) {
+        return 0;
+    }
+
+    uint16_t space;
+    memcpy(&space, _pdu + LDP_PDU_HDR_LEN + sizeof(uint32_t), sizeof(space));
+
+    return ntohs(space);
+}
+
+/**
+ * @brief get the entire pdu, header included.
+ *
+ * @return const uint8_t* pdu, size() bytes.
+ */
+const uint8_t* LdpPduView::data() const {
+    return _pdu;
+}
+
+size_t LdpPduView::size() const {
+    return _len;
+}
+
+LdpMessageIterator LdpPduView::begin() const {
+    if (_pdu == nullptr) {
+        return LdpMessageIterator(nullptr, nullptr);
+    }
+
+    return LdpMessageIterator(_pdu + LDP_PDU_MIN_LEN, _pdu + _len);
+}
+
+LdpMessageIterator LdpPduView::end() const {
+    if (_pdu == nullptr) {
+        return LdpMessageIterator(nullptr, nullptr);
+    }
+
+    return LdpMessageIterator(_pdu + _len, _pdu + _len);
+}
+
+}
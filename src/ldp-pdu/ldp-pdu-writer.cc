@@ -0,0 +1,334 @@
+#include "utils/log.hh"
+#include "ldp-pdu/ldp-pdu-writer.hh"
+#include "ldp-pdu/ldp-pdu.hh"
+#include "ldp-pdu/ldp-pdu-reassembler.hh"
+#include "ldp-message/ldp-message-view.hh"
+#include "ldp-tlv/ldp-tlv-view.hh"
+
+#include <string.h>
+#include <arpa/inet.h>
+
+namespace ldpd {
+
+LdpPduWriter::LdpPduWriter() {
+    reset(nullptr, 0);
+}
+
+LdpPduWriter::LdpPduWriter(uint8_t *buffer, size_t size) {
+    reset(buffer, size);
+}
+
+/**
+ * @brief start over w/ a new buffer.
+ *
+ * @param buffer where to encode the pdu.
+ * @param size size of the buffer - the largest pdu that can be encoded.
+ */
+void LdpPduWriter::reset(uint8_t *buffer, size_t size) {
+    _buffer = buffer;
+    _size = size;
+    _pos = 0;
+    _msg = 0;
+    _tlv = 0;
+    _messages = 0;
+    _failed = false;
+}
+
+/**
+ * @brief write the pdu header.
+ *
+ * @param routerId router id in network byte order.
+ * @param labelSpace label space in host byte order.
+ * @return ssize_t bytes written, or -1 on error.
+ */
+ssize_t LdpPduWriter::begin(uint32_t routerId, uint16_t labelSpace) {
+    if (_pos != 0) {
+        log_error("pdu already started.\n");
+        return -1;
+    }
+
+    if (putU16(LDP_VERSION) < 0 || putU16(0) < 0 || put(&routerId, sizeof(routerId)) < 0 || putU16(labelSpace) < 0) {
+        return -1;
+    }
+
+    return _pos;
+}
+
+/**
+ * @brief finish the pdu: patch its length field.
+ *
+ * note: a message still open is dropped.
+ *
+ * @return ssize_t size of the pdu (header included), or -1 on error.
+ */
+ssize_t LdpPduWriter::end() {
+    if (_pos < LDP_PDU_MIN_LEN) {
+        log_error("pdu not started.\n");
+        return -1;
+    }
+
+    if (_msg != 0) {
+        log_warn("message still open at end of pdu, dropped.\n");
+        rollbackMessage();
+    }
+
+    if (_pos > LDP_PDU_MAX_LEN) {
+        log_error("pdu too large (%zu bytes).\n", _pos);
+        return -1;
+    }
+
+    patchLength(sizeof(uint16_t), _pos - LDP_PDU_HDR_LEN);
+
+    return _pos;
+}
+
+/**
+ * @brief start a message.
+ *
+ * @param type message type.
+ * @param id message id.
+ * @return ssize_t bytes written, or -1 on error.
+ */
+ssize_t LdpPduWriter::beginMessage(uint16_t type, uint32_t id) {
+    if (_failed) {
+        return -1;
+    }
+
+    if (_pos < LDP_PDU_MIN_LEN || _msg != 0) {
+        log_error("pdu not started, or message already open.\n");
+        return -1;
+    }
+
+    size_t start = _pos;
+
+    if (putU16(type) < 0 || putU16(0) < 0 || putU32(id) < 0) {
+        _pos = start;
+        return -1;
+    }
+
+    _msg = start;
+
+    return LDP_MSG_MIN_LEN;
+}
+
+/**
+ * @brief finish the open message: patch its length field.
+ *
+ * @return ssize_t size of the message (header included), or -1 on error.
+ */
+ssize_t LdpPduWriter::endMessage() {
+    if (_msg == 0 || _failed) {
+        return -1;
+    }
+
+    if (_tlv != 0) {
+        log_error("tlv still open at end of message.\n");
+        return -1;
+    }
+
+    size_t len = _pos - _msg;
+
+    patchLength(_msg + sizeof(uint16_t), len - LDP_MSG_HDR_LEN);
+
+    _msg = 0;
+    ++_messages;
+
+    return len;
+}
+
+/**
+ * @brief drop the open message (e.g. it didn't fit), and clear the error.
+ */
+void LdpPduWriter::rollbackMessage() {
+    if (_msg != 0) {
+        _pos = _msg;
+    }
+
+    _msg = 0;
+    _tlv = 0;
+    _failed = false;
+}
+
+/**
+ * @brief start a tlv in the open message. the value is written with the
+ * put*() calls.
+ *
+ * @param type tlv type (u and f bits included).
+ * @return ssize_t bytes written, or -1 on error.
+ */
+ssize_t LdpPduWriter::beginTlv(uint16_t type) {
+    if (_failed) {
+        return -1;
+    }
+
+    if (_msg == 0 || _tlv != 0) {
+        log_error("no message open, or tlv already open.\n");
+        return -1;
+    }
+
+    size_t start = _pos;
+
+    if (putU16(type) < 0 || putU16(0) < 0) {
+        return -1;
+    }
+
+    _tlv = start;
+
+    return LDP_TLV_HDR_LEN;
+}
+
+/**
+ * @brief finish the open tlv: patch its length field.
+ *
+ * @return ssize_t size of the tlv (header included), or -1 on error.
+ */
+ssize_t LdpPduWriter::endTlv() {
+    if (_tlv == 0 || _failed) {
+        return -1;
+    }
+
+    size_t len = _pos - _tlv;
+
+    patchLength(_tlv + sizeof(uint16_t), len - LDP_TLV_HDR_LEN);
+
+    _tlv = 0;
+
+    return len;
+}
+
+/**
+ * @brief add a tlv w/ the given value to the open message.
+ *
+ * @param value value object.
+ * @return ssize_t size of the tlv (header included), or -1 on error.
+ */
+ssize_t LdpPduWriter::addTlv(const LdpTlvValue &value) {
+    if (beginTlv(value.getType()) < 0) {
+        return -1;
+    }
+
+    ssize_t len = value.write(_buffer + _pos, remaining());
+
+    if (len < 0) {
+        _failed = true;
+        return -1;
+    }
+
+    _pos += len;
+
+    return endTlv();
+}
+
+/**
+ * @brief copy an encoded tlv (header included) to the open message.
+ *
+ * @param tlv the tlv.
+ * @param len size of the tlv.
+ * @return ssize_t bytes written, or -1 on error.
+ */
+ssize_t LdpPduWriter::addRawTlv(const uint8_t *tlv, size_t len) {
+    if (_failed) {
+        return -1;
+    }
+
+    if (_msg == 0 || _tlv != 0) {
+        log_error("no message open, or tlv already open.\n");
+        return -1;
+    }
+
+    return put(tlv, len);
+}
+
+ssize_t LdpPduWriter::putU8(uint8_t value) {
+    return put(&value, sizeof(value));
+}
+
+/**
+ * @brief append a 16-bit value.
+ *
+ * @param value value in host byte order.
+ * @return ssize_t bytes written, or -1 on error.
+ */
+ssize_t LdpPduWriter::putU16(uint16_t value) {
+    value = htons(value);
+
+    return put(&value, sizeof(value));
+}
+
+/**
+ * @brief append a 32-bit value.
+ *
+ * @param value value in host byte order.
+ * @return ssize_t bytes written, or -1 on error.
+ */
+ssize_t LdpPduWriter::putU32(uint32_t value) {
+    value = htonl(value);
+
+    return put(&value, sizeof(value));
+}
+
+/**
+ * @brief append bytes as they are.
+ *
+ * @param data bytes.
+ * @param len number of bytes.
+ * @return ssize_t bytes written, or -1 on error.
+ */
+ssize_t LdpPduWriter::put(const void *data, size_t len) {
+    if (_failed) {
+        return -1;
+    }
+
+    if (len > remaining()) {
+        _failed = true;
+        return -1;
+    }
+
+    memcpy(_buffer + _pos, data, len);
+    _pos += len;
+
+    return len;
+}
+
+const uint8_t* LdpPduWriter::data() const {
+    return _buffer;
+}
+
+/**
+ * @brief get number of bytes written so far.
+ *
+ * @return size_t bytes.
+ */
+size_t LdpPduWriter::length() const {
+    return _pos;
+}
+
+size_t LdpPduWriter::remaining() const {
+    return _size - _pos;
+}
+
+/**
+ * @brief get number of complete messages in the pdu.
+ *
+ * @return size_t messages.
+ */
+size_t LdpPduWriter::messages() const {
+    return _messages;
+}
+
+/**
+ * @brief test if something did not fit.
+ *
+ * @return true if a write failed since the last reset()/rollbackMessage().
+ * @return false otherwise.
+ */
+bool LdpPduWriter::failed() const {
+    return _failed;
+}
+
+void LdpPduWriter::patchLength(size_t at, size_t len) {
+    uint16_t val = htons((uint16_t) len);
+    memcpy(_buffer + at, &val, sizeof(val));
+}
+
+}
@@ -1,5 +1,6 @@
 #include "utils/value-ops.hh"
 #include "ldp-pdu/ldp-pdu.hh"
+#include "ldp-pdu/ldp-pdu-view.hh"
 #include "utils/log.hh"
 
 #include <arpa/inet.h>
@@ -8,11 +9,19 @@
 
 namespace ldpd {
 
-LdpPdu::LdpPdu() : _messages() {
+/**
+ * @brief create a pdu.
+ * 
+ * @param arena arena to allocate the messages parsed into this pdu (and the
+ * pdu's own bookkeeping) from. nullptr to use the heap. if set, the arena
+ * must outlive the pdu.
+ */
+LdpPdu::LdpPdu(Arena *arena) : _messages(ArenaAllocator<LdpMessage *>(arena)) {
     _version = LDP_VERSION;
     _length = 0;
     _routerId = 0;
     _labelSpace = 0;
+    _arena = arena;
 }
 
 LdpPdu::~LdpPdu() {
@@ -112,6 +121,8 @@ ssize_t LdpPdu::setLabelSpace(uint16_t labelSpace) {
  * 
  * note: LdpPdu class handles freeing of the LdpMessage objects. DO NOT free it
  * yourself after adding message to pdu. DO NOT pass local variable pointer.
+ * the message may come from the heap or from an arena (new (arena)
+ * LdpMessage(arena)).
  * 
  * note: this also update length field.
  * 
@@ -168,7 +179,7 @@ ssize_t LdpPdu::setRouterIdString(const char* id) {
  * @return const std::vector<LdpRawMessage * list of messages.
  */
 const std::vector<LdpMessage *> LdpPdu::getMessages() const {
-    return _messages;
+    return std::vector<LdpMessage *>(_messages.begin(), _messages.end());
 }
 
 const LdpMessage* LdpPdu::getMessage(uint16_t type) const {
@@ -201,47 +212,51 @@ uint16_t LdpPdu::recalculateLength() {
 }
 
 /**
- * @brief parse ldp pdu from buffer.
+ * @brief parse ldp pdu from buffer. the pdu is checked in full (see
+ * LdpPduView::parse) before anything is built, so a bad pdu never leaves a
+ * half-built one behind.
  * 
  * @param from source.
  * @param msg_sz buffer length.
  * @return ssize_t btyes parsed, or -1 on error.
  */
 ssize_t LdpPdu::parse(const uint8_t *from, size_t msg_sz) {
-    const uint8_t *ptr = from;
-    size_t buf_remaining = msg_sz;
+    LdpPduView pdu = LdpPduView();
 
-    if (buf_remaining < (sizeof(_version) + sizeof(_length) + sizeof(_routerId) + sizeof(_labelSpace))) {
-        log_fatal("invalid packet: too small (size is %zu)\n", buf_remaining);
+    if (pdu.parse(from, msg_sz) < 0) {
         return -1;
     }
 
-    GETVAL_S(ptr, buf_remaining, uint16_t, _version, ntohs, -1);
-    GETVAL_S(ptr, buf_remaining, uint16_t, _length, ntohs, -1);
-    GETVAL_S(ptr, buf_remaining, uint32_t, _routerId, , -1);
-    GETVAL_S(ptr, buf_remaining, uint16_t, _labelSpace, ntohs, -1);
-
-    if (_version != LDP_VERSION) {
-        log_fatal("unknow ldp version: %u\n", _version);
-        return -1;
-    }
+    return parse(pdu);
+}
 
-    size_t msgs_len = _length - sizeof(_routerId) - sizeof(_labelSpace);
+/**
+ * @brief build the pdu from one that was already checked - no further checks
+ * are done.
+ * 
+ * @param pdu the pdu.
+ * @return ssize_t bytes parsed, or -1 on error.
+ */
+ssize_t LdpPdu::parse(const LdpPduView &pdu) {
+    clearMessages();
 
-    if (msgs_len > buf_remaining) {
-        log_fatal("msgs_len (%zu) greater then remaining buffer (%zu), packet truncated?\n", msgs_len, buf_remaining);
-        return -1;
-    }
+    _version = pdu.getVersion();
+    _length = pdu.getLength();
+    _routerId = pdu.getRouterId();
+    _labelSpace = pdu.getLabelSpace();
 
-    while (msgs_len > 0) {
-        LdpMessage *msg = new LdpMessage();
+    for (const LdpMessageView msg : pdu) {
+        LdpMessage *parsed = new (_arena) LdpMessage(_arena);
 
-        PARSE_S(ptr, msgs_len, msg, -1, true);
+        if (parsed->parse(msg) < 0) {
+            delete parsed;
+            return -1;
+        }
 
-        this->addMessage(msg);
+        this->addMessage(parsed);
     }
 
-    return ptr - from;
+    return pdu.size();
 }
 
 /**
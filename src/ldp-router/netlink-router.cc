@@ -71,6 +71,61 @@ std::vector<const Route *>  NetlinkRouter::getRoutes() {
     return rslt;
 }
 
+/**
+ * @brief find the route to a prefix in the rib.
+ *
+ * @param prefix the prefix - dst and dst len must both match.
+ * @return const Ipv4Route* the route, or nullptr if none.
+ */
+const Ipv4Route* NetlinkRouter::findIpv4Route(const Prefix &prefix) {
+    Ipv4Route selector = Ipv4Route();
+    selector.dst = prefix.prefix;
+    selector.dst_len = prefix.len;
+
+    auto range = _rib.equal_range(selector.hash());
+
+    for (auto i = range.first; i != range.second; ++i) {
+        if (i->second->getType() != RouteType::Ipv4) {
+            continue;
+        }
+
+        const Ipv4Route *route = (const Ipv4Route *) i->second;
+
+        if (route->dst == prefix.prefix && route->dst_len == prefix.len) {
+            return route;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief find the route for an in label in the rib.
+ *
+ * @param label the in label.
+ * @return const MplsRoute* the route, or nullptr if none.
+ */
+const MplsRoute* NetlinkRouter::findMplsRoute(uint32_t label) {
+    MplsRoute selector = MplsRoute();
+    selector.in_label = label;
+
+    auto range = _rib.equal_range(selector.hash());
+
+    for (auto i = range.first; i != range.second; ++i) {
+        if (i->second->getType() != RouteType::Mpls) {
+            continue;
+        }
+
+        const MplsRoute *route = (const MplsRoute *) i->second;
+
+        if (route->in_label == label) {
+            return route;
+        }
+    }
+
+    return nullptr;
+}
+
 uint64_t NetlinkRouter::addRoute(Route *route) {
     uint64_t key = route->hash();
     _rib.insert(std::make_pair(key, route));
@@ -198,6 +253,10 @@ void NetlinkRouter::onRouteChange(void* data, ldp_routechange_handler_t handler)
     _routechange_data = data;
 }
 
+int NetlinkRouter::getFd() const {
+    return _nl.getFd();
+}
+
 void NetlinkRouter::tick() {
     _nl.tick();
 
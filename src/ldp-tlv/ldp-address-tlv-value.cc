@@ -3,6 +3,7 @@
 #include "ldp-tlv/ldp-tlv-types.hh"
 #include "ldp-tlv/ldp-address-tlv-value.hh"
 
+#include <string.h>
 #include <arpa/inet.h>
 
 namespace ldpd {
@@ -33,6 +34,19 @@ ssize_t LdpAddressTlvValue::addAddress(uint32_t address) {
     return sizeof(uint32_t);
 }
 
+/**
+ * @brief add addresses in bulk.
+ * 
+ * @param addresses addresses in network byte order.
+ * @param count number of addresses.
+ * @return ssize_t bytes added.
+ */
+ssize_t LdpAddressTlvValue::addAddresses(const uint32_t *addresses, size_t count) {
+    _addresses.insert(_addresses.end(), addresses, addresses + count);
+
+    return count * sizeof(uint32_t);
+}
+
 ssize_t LdpAddressTlvValue::parse(const uint8_t *from, size_t tlv_sz) {
     uint16_t af;
 
@@ -42,20 +56,21 @@ ssize_t LdpAddressTlvValue::parse(const uint8_t *from, size_t tlv_sz) {
     GETVAL_S(ptr, buf_remaining, uint16_t, af, ntohs, -1);
     
     if (af != 1) {
-        log_fatal("unsupported af: %u\n", af);
         return -1;
     }
 
     if (buf_remaining % sizeof(uint32_t) != 0) {
-        log_fatal("addr list len not multiple of uint32_t, bad pkt.\n");
         return -1;
     }
 
-    while (buf_remaining > 0) {
-        uint32_t addr;
-        GETVAL_S(ptr, buf_remaining, uint32_t, addr, , -1);
-        this->addAddress(addr);
-    }
+    // addresses stay in network byte order - the whole list is copied at once.
+    size_t count = buf_remaining / sizeof(uint32_t);
+    size_t old_count = _addresses.size();
+
+    _addresses.resize(old_count + count);
+    memcpy(_addresses.data() + old_count, ptr, count * sizeof(uint32_t));
+
+    ptr += count * sizeof(uint32_t);
 
     return ptr - from;
 }
@@ -66,10 +81,16 @@ ssize_t LdpAddressTlvValue::write(uint8_t *to, size_t buf_sz) const {
 
     PUTVAL_S(ptr, buf_remaining, uint16_t, 1, htons, -1);
 
-    for (const uint32_t &addr : _addresses) {
-        PUTVAL_S(ptr, buf_remaining, uint32_t, addr, , -1);
+    size_t list_len = _addresses.size() * sizeof(uint32_t);
+
+    if (buf_remaining < list_len) {
+        log_fatal("buf_sz (%zu) too small - want (%zu)\n", buf_sz, this->length());
+        return -1;
     }
 
+    memcpy(ptr, _addresses.data(), list_len);
+    ptr += list_len;
+
     return ptr - to;
 }
 
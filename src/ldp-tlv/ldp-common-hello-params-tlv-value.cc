@@ -65,7 +65,6 @@ ssize_t LdpCommonHelloParamsTlvValue::setGtsm(bool gtsm) {
 
 ssize_t LdpCommonHelloParamsTlvValue::parse(const uint8_t *from, size_t tlv_sz) {
     if (tlv_sz != this->length()) {
-        log_fatal("bad length. common-hello-params-tlv must be len %zu, but got %zu.\n", this->length(), tlv_sz);
         return -1;
     }
 
@@ -31,7 +31,6 @@ ssize_t LdpConfigSeqNumTlvValue::setSeq(uint32_t seq) {
 
 ssize_t LdpConfigSeqNumTlvValue::parse(const uint8_t *from, size_t tlv_sz) {
     if (tlv_sz != this->length()) {
-        log_fatal("bad length. need len %zu, but got %zu.\n", this->length(), tlv_sz);
         return -1;
     }
 
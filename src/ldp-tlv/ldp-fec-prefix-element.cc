@@ -12,7 +12,7 @@ LdpFecPrefixElement::LdpFecPrefixElement() {
 }    
 
 uint8_t LdpFecPrefixElement::getType() const {
-    return 0x02;
+    return LDP_FEC_PREFIX;
 }
 
 uint32_t LdpFecPrefixElement::getPrefix() const {
@@ -51,7 +51,6 @@ ssize_t LdpFecPrefixElement::parse(const uint8_t *from, size_t buf_sz) {
     size_t min_ele_sz = sizeof(_prelen) + sizeof(uint16_t);
 
     if (buf_sz < min_ele_sz) {
-        log_fatal("buf_sz (%zu) smaller then ele_sz (%zu), packet truncated?\n", buf_sz, min_ele_sz);
         return -1;
     }
 
@@ -63,7 +62,6 @@ ssize_t LdpFecPrefixElement::parse(const uint8_t *from, size_t buf_sz) {
     GETVAL_S(ptr, buf_remaining, uint16_t, af, ntohs, -1);
 
     if (af != 1) {
-        log_fatal("unknow af: %u\n", af);
         return -1;
     }
 
@@ -72,7 +70,6 @@ ssize_t LdpFecPrefixElement::parse(const uint8_t *from, size_t buf_sz) {
     size_t prefix_buf_len = (_prelen + 7) / 8;
 
     if (buf_remaining < prefix_buf_len) {
-        log_fatal("buf_remaining (%zu) smaller then prefix_buf_len (%zu), packet truncated?\n", buf_remaining, prefix_buf_len);
         return -1;
     }
 
@@ -1,14 +1,19 @@
 #include "utils/log.hh"
 #include "utils/value-ops.hh"
 #include "ldp-tlv/ldp-tlv-types.hh"
-#include "ldp-tlv/ldp-fec-prefix-element.hh"
-#include "ldp-tlv/ldp-fec-wildcard-element.hh"
 #include "ldp-tlv/ldp-fec-tlv-value.hh"
+#include "ldp-tlv/ldp-tlv-registry.hh"
 
 namespace ldpd {
 
-LdpFecTlvValue::LdpFecTlvValue() : _elements() {
-
+/**
+ * @brief create a fec tlv value.
+ * 
+ * @param arena arena to allocate the elements parsed into this value from.
+ * nullptr to use the heap.
+ */
+LdpFecTlvValue::LdpFecTlvValue(Arena *arena) : _elements(ArenaAllocator<LdpFecElement *>(arena)) {
+    _arena = arena;
 }
 
 LdpFecTlvValue::~LdpFecTlvValue() {
@@ -20,7 +25,7 @@ uint16_t LdpFecTlvValue::getType() const {
 }
 
 const std::vector<LdpFecElement *> LdpFecTlvValue::getElements() const {
-    return _elements;
+    return std::vector<LdpFecElement *>(_elements.begin(), _elements.end());
 }
 
 void LdpFecTlvValue::clearElements() {
@@ -39,7 +44,6 @@ ssize_t LdpFecTlvValue::addElement(LdpFecElement *element) {
 
 ssize_t LdpFecTlvValue::parse(const uint8_t *from, size_t tlv_len) {
     if (tlv_len < 1) {
-        log_fatal("tlv_len (%zu) is not correct (fec tlv value must be > 1 byte)\n", tlv_len);
         return -1;
     }
 
@@ -50,24 +54,9 @@ ssize_t LdpFecTlvValue::parse(const uint8_t *from, size_t tlv_len) {
         uint8_t type;
         GETVAL_S(ptr, buf_remaining, uint8_t, type, , -1);
 
-        LdpFecElement *el = nullptr;
-
-        switch (type) {
-            case 0x01: {
-                el = (LdpFecElement *) new LdpFecWildcardElement();
-                break;
-            }
-            case 0x02: {
-                el = (LdpFecElement *) new LdpFecPrefixElement();
-                break;
-            }
-            default:
-                log_fatal("unknow fec element type (0x%.2x)\n", type);
-                return -1;
-        }
+        LdpFecElement *el = LdpFecRegistry::create(type, _arena);
 
         if (el == nullptr) {
-            log_fatal("no fec parser selected? type is 0x%.2x\n", type);
             return -1;
         }
 
@@ -77,7 +66,6 @@ ssize_t LdpFecTlvValue::parse(const uint8_t *from, size_t tlv_len) {
     }
 
     if (buf_remaining != 0) {
-        log_fatal("reached the end but buf not end (%zu over).\n", buf_remaining);
         return -1;
     }
 
@@ -0,0 +1,92 @@
+#include "utils/log.hh"
+#include "utils/value-ops.hh"
+#include "ldp-tlv/ldp-fec-typed-wildcard-element.hh"
+
+#include <arpa/inet.h>
+
+namespace ldpd {
+
+LdpFecTypedWildcardElement::LdpFecTypedWildcardElement() {
+    _fec_type = LDP_FEC_PREFIX;
+    _af = 1;
+}
+
+uint8_t LdpFecTypedWildcardElement::getType() const {
+    return LDP_FEC_TYPED_WILDCARD;
+}
+
+uint8_t LdpFecTypedWildcardElement::getFecType() const {
+    return _fec_type;
+}
+
+/**
+ * @brief get address family of the fecs (1 for ipv4).
+ *
+ * @return uint16_t address family in host byte order. 0 if the fec type is not
+ * prefix.
+ */
+uint16_t LdpFecTypedWildcardElement::getAddressFamily() const {
+    return _fec_type == LDP_FEC_PREFIX ? _af : 0;
+}
+
+ssize_t LdpFecTypedWildcardElement::setFecType(uint8_t type) {
+    _fec_type = type;
+
+    return sizeof(_fec_type);
+}
+
+ssize_t LdpFecTypedWildcardElement::setAddressFamily(uint16_t af) {
+    _af = af;
+
+    return sizeof(_af);
+}
+
+ssize_t LdpFecTypedWildcardElement::parse(const uint8_t *from, size_t buf_sz) {
+    size_t buf_remaining = buf_sz;
+    const uint8_t *ptr = from;
+
+    uint8_t info_len;
+
+    GETVAL_S(ptr, buf_remaining, uint8_t, _fec_type, , -1);
+    GETVAL_S(ptr, buf_remaining, uint8_t, info_len, , -1);
+
+    if (_fec_type != LDP_FEC_PREFIX) {
+        if (info_len != 0) {
+            return -1;
+        }
+
+        _af = 0;
+
+        return ptr - from;
+    }
+
+    if (info_len != sizeof(uint16_t)) {
+        return -1;
+    }
+
+    GETVAL_S(ptr, buf_remaining, uint16_t, _af, ntohs, -1);
+
+    return ptr - from;
+}
+
+ssize_t LdpFecTypedWildcardElement::write(uint8_t *to, size_t buf_sz) const {
+    size_t buf_remaining = buf_sz;
+    uint8_t *ptr = to;
+
+    uint8_t info_len = _fec_type == LDP_FEC_PREFIX ? sizeof(uint16_t) : 0;
+
+    PUTVAL_S(ptr, buf_remaining, uint8_t, _fec_type, , -1);
+    PUTVAL_S(ptr, buf_remaining, uint8_t, info_len, , -1);
+
+    if (info_len != 0) {
+        PUTVAL_S(ptr, buf_remaining, uint16_t, _af, htons, -1);
+    }
+
+    return ptr - to;
+}
+
+size_t LdpFecTypedWildcardElement::length() const {
+    return sizeof(uint8_t) + sizeof(uint8_t) + (_fec_type == LDP_FEC_PREFIX ? sizeof(uint16_t) : 0);
+}
+
+}
@@ -0,0 +1,87 @@
+#include "ldp-tlv/ldp-fec-view.hh"
+
+#include <string.h>
+#include <arpa/inet.h>
+
+namespace ldpd {
+
+LdpFecView::LdpFecView(const LdpTlvView &fec) {
+    _value = fec.getValue();
+    _len = fec.getLength();
+    _offset = 0;
+}
+
+/**
+ * @brief get the next element.
+ *
+ * @param type set to the element type (LDP_FEC_WILDCARD or LDP_FEC_PREFIX).
+ * @param prefix set to the prefix in network byte order. 0 for wildcard.
+ * @param prefixLength set to the prefix length. 0 for wildcard.
+ * @param err if not nullptr, set to what went wrong on error. the offset is
+ * from the start of the fec tlv, header included.
+ * @return int 1 if an element is returned, 0 if there are no more elements,
+ * or -1 if the element can not be parsed.
+ */
+int LdpFecView::next(uint8_t &type, uint32_t &prefix, uint8_t &prefixLength, LdpParseError *err) {
+    if (_value == nullptr || _offset >= _len) {
+        return 0;
+    }
+
+    const uint8_t *ptr = _value + _offset;
+    size_t buf_remaining = _len - _offset;
+    size_t at = LDP_TLV_HDR_LEN + _offset;
+
+    type = ptr[0];
+    prefix = 0;
+    prefixLength = 0;
+
+    if (type == LDP_FEC_WILDCARD) {
+        _offset += sizeof(uint8_t);
+        return 1;
+    }
+
+    if (type != LDP_FEC_PREFIX) {
+        LDP_PARSE_FAIL(err, ParseUnknownFec, at);
+    }
+
+    // type, af, prefix length.
+    size_t hdr_len = sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint8_t);
+
+    if (buf_remaining < hdr_len) {
+        LDP_PARSE_FAIL(err, ParseMalformedValue, at);
+    }
+
+    uint16_t af;
+    memcpy(&af, ptr + sizeof(uint8_t), sizeof(af));
+
+    if (ntohs(af) != 1) {
+        LDP_PARSE_FAIL(err, ParseUnsupportedAf, at + sizeof(uint8_t));
+    }
+
+    prefixLength = ptr[hdr_len - 1];
+
+    if (prefixLength > 32) {
+        LDP_PARSE_FAIL(err, ParseMalformedValue, at + hdr_len - 1);
+    }
+
+    size_t prefix_buf_len = (prefixLength + 7) / 8;
+
+    if (buf_remaining - hdr_len < prefix_buf_len) {
+        LDP_PARSE_FAIL(err, ParseMalformedValue, at + hdr_len);
+    }
+
+    memcpy(&prefix, ptr + hdr_len, prefix_buf_len);
+
+    _offset += hdr_len + prefix_buf_len;
+
+    return 1;
+}
+
+/**
+ * @brief go back to the first element.
+ */
+void LdpFecView::rewind() {
+    _offset = 0;
+}
+
+}
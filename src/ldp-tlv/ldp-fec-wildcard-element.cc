@@ -7,7 +7,7 @@
 namespace ldpd {
 
 uint8_t LdpFecWildcardElement::getType() const {
-    return 0x01;
+    return LDP_FEC_WILDCARD;
 }
 
 ssize_t LdpFecWildcardElement::parse(__attribute__((unused)) const uint8_t *from, __attribute__((unused)) size_t buf_sz) {
@@ -53,7 +53,6 @@ ssize_t LdpGenericLabelTlvValue::setLabel(uint32_t label) {
  */
 ssize_t LdpGenericLabelTlvValue::parse(const uint8_t *from, size_t tlv_len) {
     if (tlv_len != sizeof(uint32_t)) {
-        log_fatal("tlv_len (%zu) is not correct (generic lbl tlv value must be size %zu)\n", tlv_len, sizeof(uint32_t));
         return -1;
     }
 
@@ -0,0 +1,51 @@
+#include "utils/log.hh"
+#include "utils/value-ops.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
+#include "ldp-tlv/ldp-hop-count-tlv-value.hh"
+
+namespace ldpd {
+
+LdpHopCountTlvValue::LdpHopCountTlvValue() {
+    _count = 0;
+}
+
+uint16_t LdpHopCountTlvValue::getType() const {
+    return LDP_TLVTYPE_HOP_COUNT;
+}
+
+/**
+ * @brief get the hop count. 0 means unknown.
+ *
+ * @return uint8_t hop count.
+ */
+uint8_t LdpHopCountTlvValue::getCount() const {
+    return _count;
+}
+
+ssize_t LdpHopCountTlvValue::setCount(uint8_t count) {
+    _count = count;
+
+    return sizeof(_count);
+}
+
+ssize_t LdpHopCountTlvValue::parse(const uint8_t *from, size_t tlv_len) {
+    if (tlv_len != sizeof(uint8_t)) {
+        return -1;
+    }
+
+    GETVAL_S(from, tlv_len, uint8_t, _count, , -1);
+
+    return sizeof(uint8_t);
+}
+
+ssize_t LdpHopCountTlvValue::write(uint8_t *to, size_t buf_sz) const {
+    PUTVAL_S(to, buf_sz, uint8_t, _count, , -1);
+
+    return sizeof(uint8_t);
+}
+
+size_t LdpHopCountTlvValue::length() const {
+    return sizeof(uint8_t);
+}
+
+}
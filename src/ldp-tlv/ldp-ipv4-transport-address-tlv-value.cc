@@ -43,7 +43,6 @@ ssize_t LdpIpv4TransportAddressTlvValue::setAddressString(const char* address) {
 
 ssize_t LdpIpv4TransportAddressTlvValue::parse(const uint8_t *from, size_t tlv_sz) {
     if (tlv_sz != this->length()) {
-        log_fatal("bad length. need len %zu, but got %zu.\n", this->length(), tlv_sz);
         return -1;
     }
 
@@ -0,0 +1,53 @@
+#include "utils/log.hh"
+#include "utils/value-ops.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
+#include "ldp-tlv/ldp-label-request-id-tlv-value.hh"
+
+#include <arpa/inet.h>
+
+namespace ldpd {
+
+LdpLabelRequestIdTlvValue::LdpLabelRequestIdTlvValue() {
+    _id = 0;
+}
+
+uint16_t LdpLabelRequestIdTlvValue::getType() const {
+    return LDP_TLVTYPE_LABEL_REQUEST;
+}
+
+/**
+ * @brief get id of the label request message this refers to.
+ *
+ * @return uint32_t message id in host byte order.
+ */
+uint32_t LdpLabelRequestIdTlvValue::getMessageId() const {
+    return _id;
+}
+
+ssize_t LdpLabelRequestIdTlvValue::setMessageId(uint32_t id) {
+    _id = id;
+
+    return sizeof(_id);
+}
+
+ssize_t LdpLabelRequestIdTlvValue::parse(const uint8_t *from, size_t tlv_len) {
+    if (tlv_len != sizeof(uint32_t)) {
+        return -1;
+    }
+
+    GETVAL_S(from, tlv_len, uint32_t, _id, ntohl, -1);
+
+    return sizeof(uint32_t);
+}
+
+ssize_t LdpLabelRequestIdTlvValue::write(uint8_t *to, size_t buf_sz) const {
+    PUTVAL_S(to, buf_sz, uint32_t, _id, htonl, -1);
+
+    return sizeof(uint32_t);
+}
+
+size_t LdpLabelRequestIdTlvValue::length() const {
+    return sizeof(uint32_t);
+}
+
+}
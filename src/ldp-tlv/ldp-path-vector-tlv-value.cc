@@ -0,0 +1,83 @@
+#include "utils/log.hh"
+#include "utils/value-ops.hh"
+#include "ldp-tlv/ldp-tlv-types.hh"
+#include "ldp-tlv/ldp-path-vector-tlv-value.hh"
+
+#include <string.h>
+
+namespace ldpd {
+
+LdpPathVectorTlvValue::LdpPathVectorTlvValue() : _lsr_ids() {
+
+}
+
+LdpPathVectorTlvValue::~LdpPathVectorTlvValue() {
+
+}
+
+uint16_t LdpPathVectorTlvValue::getType() const {
+    return LDP_TLVTYPE_PATH_VECTOR;
+}
+
+/**
+ * @brief get the lsr ids on the path, in the order they were added.
+ *
+ * @return const std::vector<uint32_t> lsr ids in network byte order.
+ */
+const std::vector<uint32_t> LdpPathVectorTlvValue::getLsrIds() const {
+    return _lsr_ids;
+}
+
+void LdpPathVectorTlvValue::clearLsrIds() {
+    _lsr_ids.clear();
+}
+
+/**
+ * @brief add a lsr id to the path.
+ *
+ * @param lsrId lsr id in network byte order.
+ * @return ssize_t bytes added.
+ */
+ssize_t LdpPathVectorTlvValue::addLsrId(uint32_t lsrId) {
+    _lsr_ids.push_back(lsrId);
+
+    return sizeof(uint32_t);
+}
+
+ssize_t LdpPathVectorTlvValue::parse(const uint8_t *from, size_t tlv_sz) {
+    if (tlv_sz % sizeof(uint32_t) != 0) {
+        return -1;
+    }
+
+    const uint8_t *ptr = from;
+    size_t buf_remaining = tlv_sz;
+
+    size_t count = buf_remaining / sizeof(uint32_t);
+    size_t old_count = _lsr_ids.size();
+
+    _lsr_ids.resize(old_count + count);
+    memcpy(_lsr_ids.data() + old_count, ptr, count * sizeof(uint32_t));
+
+    ptr += count * sizeof(uint32_t);
+
+    return ptr - from;
+}
+
+ssize_t LdpPathVectorTlvValue::write(uint8_t *to, size_t buf_sz) const {
+    size_t len = this->length();
+
+    if (buf_sz < len) {
+        log_fatal("buf_sz (%zu) too small - want (%zu)\n", buf_sz, len);
+        return -1;
+    }
+
+    memcpy(to, _lsr_ids.data(), len);
+
+    return len;
+}
+
+size_t LdpPathVectorTlvValue::length() const {
+    return sizeof(uint32_t) * _lsr_ids.size();
+}
+
+}
@@ -13,15 +13,21 @@
 
 namespace ldpd {
     
-LdpRawTlv::LdpRawTlv() {
+/**
+ * @brief create a tlv.
+ * 
+ * @param arena arena to allocate the tlv buffer from. nullptr to use the heap.
+ */
+LdpRawTlv::LdpRawTlv(Arena *arena) {
     _raw_buffer = nullptr;
     _raw_buffer_size = 0;
+    _arena = arena;
+    _value = nullptr;
+    _value_parsed = false;
 }
 
 LdpRawTlv::~LdpRawTlv() {
-    if (_raw_buffer != nullptr) {
-        free(_raw_buffer);
-    }
+    freeBuffer();
 }
 
 /**
@@ -93,6 +99,8 @@ const uint8_t* LdpRawTlv::peekRawValue() const {
 ssize_t LdpRawTlv::setType(uint16_t type) {
     NEED_MIN_BUFSZ(sizeof(uint16_t), -1);
 
+    dropCachedValue();
+
     ((uint16_t *) _raw_buffer)[0] = htons(type);
 
     return sizeof(uint16_t);
@@ -108,6 +116,8 @@ ssize_t LdpRawTlv::setType(uint16_t type) {
 ssize_t LdpRawTlv::setLength(uint16_t length) {
     NEED_MIN_BUFSZ(2 * sizeof(uint16_t), -1);
 
+    dropCachedValue();
+
     ((uint16_t *) _raw_buffer)[1] = htons(length);
 
     return sizeof(uint16_t);
@@ -134,14 +144,10 @@ ssize_t LdpRawTlv::setLength(uint16_t length) {
 ssize_t LdpRawTlv::setRawValue(size_t size, const uint8_t *src) {
     size_t tlv_hdr_sz = 2 * sizeof(uint16_t);
 
-    _raw_buffer_size = tlv_hdr_sz + size;
-
-    if (_raw_buffer == nullptr) {
-        _raw_buffer = (uint8_t *) malloc(_raw_buffer_size);
-    }
+    dropCachedValue();
 
-    if (_raw_buffer != nullptr) {
-        _raw_buffer = (uint8_t *) realloc(_raw_buffer, _raw_buffer_size);
+    if (!resizeBuffer(tlv_hdr_sz + size)) {
+        return -1;
     }
 
     memcpy(_raw_buffer + tlv_hdr_sz, src, size);
@@ -158,18 +164,16 @@ ssize_t LdpRawTlv::setRawValue(size_t size, const uint8_t *src) {
  * @return new buffer length (the entire tlv), or -1 on error.
  */
 ssize_t LdpRawTlv::setValue(const LdpTlvValue *value) {
-    if (_raw_buffer != nullptr) {
-        free(_raw_buffer);
-    }
+    freeBuffer();
 
     uint16_t val_sz = value->length();
     uint16_t val_type = value->getType();
 
     size_t tlv_hdr_sz = sizeof(val_sz) + sizeof(val_type);
 
-    _raw_buffer_size = tlv_hdr_sz + value->length();
-
-    _raw_buffer = (uint8_t *) malloc(_raw_buffer_size);
+    if (!resizeBuffer(tlv_hdr_sz + val_sz)) {
+        return -1;
+    }
 
     uint8_t *ptr = _raw_buffer;
     size_t buf_remaining = _raw_buffer_size;
@@ -195,62 +199,117 @@ LdpTlvValue* LdpRawTlv::getParsedValue() const {
     size_t tot_len = hdr_len + len;
 
     if (tot_len > _raw_buffer_size) {
-        log_fatal("tot_len (%zu) greater then raw buffer size (%zu), bad packet?\n", tot_len, _raw_buffer_size);
         return nullptr;
     }
 
-    LdpTlvValue *val = nullptr;
+    return LdpRawTlv::parseValue(type, _raw_buffer + hdr_len, len);
+}
 
-    switch(type) {
-        case LDP_TLVTYPE_FEC: {
-            val = new LdpFecTlvValue();
-            break;
-        }
-        case LDP_TLVTYPE_ADDRESS_LIST: {
-            val = new LdpAddressTlvValue();
-            break;
-        }
-        case LDP_TLVTYPE_GENERIC_LABEL: {
-            val = new LdpGenericLabelTlvValue();
-            break;
-        }
-        case LDP_TLVTYPE_STATUS: {
-            val = new LdpStatusTlvValue();
-            break;
-        }
-        case LDP_TLVTYPE_COMMON_HELLO: {
-            val = new LdpCommonHelloParamsTlvValue();
-            break;
-        }
-        case LDP_TLVTYPE_IPV4_TRANSPORT: {
-            val = new LdpIpv4TransportAddressTlvValue();
-            break;
-        }
-        case LDP_TLVTYPE_CONFIGURATION_SEQ: {
-            val = new LdpConfigSeqNumTlvValue();
-            break;
-        }
-        case LDP_TLVTYPE_COMMON_SESSION: {
-            val = new LdpCommonSessionParamsTlvValue();
-            break;
-        }
-        default:
-            log_fatal("unknow tlv type (0x%.4x)\n", type);
-            return nullptr;
+/**
+ * @brief get the parsed value, parsing it on first use. unlike
+ * getParsedValue, the value is owned by the tlv and is kept until the tlv
+ * changes; don't free it. if the tlv has an arena, the value is allocated
+ * from it.
+ * 
+ * @return const LdpTlvValue* parsed value, or nullptr if can't be parsed.
+ */
+const LdpTlvValue* LdpRawTlv::getCachedValue() const {
+    if (_value_parsed) {
+        return _value;
     }
 
+    _value_parsed = true;
+
+    uint16_t len = this->getLength();
+
+    if (_raw_buffer == nullptr || LDP_TLV_HDR_LEN + (size_t) len > _raw_buffer_size) {
+        return nullptr;
+    }
+
+    _value = LdpRawTlv::parseValue(this->getType(), _raw_buffer + LDP_TLV_HDR_LEN, len, _arena);
+
+    return _value;
+}
+
+/**
+ * @brief parse a tlv value of the given type.
+ * 
+ * @param type tlv type.
+ * @param value value part of the tlv.
+ * @param len length of the value.
+ * @param arena arena to allocate the value from, nullptr for heap.
+ * @return LdpTlvValue* parsed value. you must free this yourself after use.
+ * return null if can't be parsed.
+ */
+LdpTlvValue* LdpRawTlv::parseValue(uint16_t type, const uint8_t *value, size_t len, Arena *arena) {
+    LdpTlvValue *val = LdpTlvRegistry::create(type, arena);
+
     if (val == nullptr) {
-        log_fatal("no val parser selected? type is 0x%.4x\n", type);
         return nullptr;
     }
 
-    uint8_t *ptr = _raw_buffer + hdr_len;
+    const uint8_t *ptr = value;
 
     PARSE_S(ptr, len, val, nullptr, true);
 
     return val;
 }
 
+/**
+ * @brief resize the raw buffer, keeping its content.
+ * 
+ * @param size new size.
+ * @return true if resized.
+ * @return false if out of memory. the buffer is left as it was.
+ */
+bool LdpRawTlv::resizeBuffer(size_t size) {
+    uint8_t *buffer;
+
+    if (_arena == nullptr) {
+        buffer = (uint8_t *) realloc(_raw_buffer, size);
+    } else {
+        // arena memory can't grow - take new space and copy over.
+        buffer = (uint8_t *) _arena->allocate(size);
+
+        if (buffer != nullptr && _raw_buffer != nullptr) {
+            memcpy(buffer, _raw_buffer, _raw_buffer_size < size ? _raw_buffer_size : size);
+        }
+    }
+
+    if (buffer == nullptr) {
+        log_error("can not allocate %zu bytes for tlv.\n", size);
+        return false;
+    }
+
+    _raw_buffer = buffer;
+    _raw_buffer_size = size;
+
+    return true;
+}
+
+/**
+ * @brief free the raw buffer. arena memory is left to the arena.
+ */
+void LdpRawTlv::freeBuffer() {
+    dropCachedValue();
+
+    if (_raw_buffer != nullptr && _arena == nullptr) {
+        free(_raw_buffer);
+    }
+
+    _raw_buffer = nullptr;
+    _raw_buffer_size = 0;
+}
+
+void LdpRawTlv::dropCachedValue() {
+    if (_value != nullptr) {
+        delete _value;
+    }
+
+    _value = nullptr;
+    _value_parsed = false;
+}
+
 // ----------------------------------------------------------------------------
 
 /**
@@ -274,24 +333,41 @@ ssize_t LdpRawTlv::parse(const uint8_t *from, size_t sz) {
     GETVAL_S(buffer, buf_remaining, uint16_t, tlv_len, ntohs, -1);
 
     if (tlv_len > buf_remaining) {
-        log_fatal("tlv_len (%u) greater then remaining buffer (%zu), packet truncated?\n", tlv_len, buf_remaining);
         return -1;
     }
 
     size_t tot_tlv_len = tlv_len + sizeof(type) + sizeof(tlv_len);
 
-    if (_raw_buffer != nullptr) {
-        free(_raw_buffer);
-    }
+    freeBuffer();
 
-    _raw_buffer = (uint8_t *) malloc(tot_tlv_len);
+    if (!resizeBuffer(tot_tlv_len)) {
+        return -1;
+    }
 
     memcpy(_raw_buffer, from, tot_tlv_len);
-    _raw_buffer_size = tot_tlv_len;
     
     return tot_tlv_len;
 }
 
+/**
+ * @brief copy a tlv that was already checked (see LdpPduView::parse) into
+ * the raw buffer.
+ * 
+ * @param tlv the tlv.
+ * @return ssize_t bytes read, or -1 on error.
+ */
+ssize_t LdpRawTlv::parse(const LdpTlvView &tlv) {
+    freeBuffer();
+
+    if (!resizeBuffer(tlv.size())) {
+        return -1;
+    }
+
+    memcpy(_raw_buffer, tlv.data(), tlv.size());
+
+    return tlv.size();
+}
+
 /**
  * @brief write tlv into buffer.
  * 
@@ -123,7 +123,6 @@ const char* LdpStatusTlvValue::getStatusCodeText() const {
 
 ssize_t LdpStatusTlvValue::parse(const uint8_t *from, size_t tlv_sz) {
     if (tlv_sz != this->length()) {
-        log_fatal("bad length. need len %zu, but got %zu.\n", this->length(), tlv_sz);
         return -1;
     }
 
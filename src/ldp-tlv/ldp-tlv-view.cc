@@ -0,0 +1,178 @@
+#include "utils/log.hh"
+#include "ldp-tlv/ldp-tlv-view.hh"
+#include "ldp-tlv/ldp-raw-tlv.hh"
+
+#include <string.h>
+#include <arpa/inet.h>
+
+namespace ldpd {
+
+LdpTlvView::LdpTlvView() {
+    _tlv = nullptr;
+    _len = 0;
+}
+
+/**
+ * @brief make a view of a tlv.
+ *
+ * note: the buffer is not checked here - it must hold at least the tlv
+ * header, and len must be the header plus the length field. use
+ * LdpMessageView::parse to check a message and its tlvs.
+ *
+ * @param tlv start of the tlv (the type field).
+ * @param len size of the entire tlv.
+ */
+LdpTlvView::LdpTlvView(const uint8_t *tlv, size_t len) {
+    _tlv = tlv;
+    _len = len;
+}
+
+/**
+ * @brief test if the view points to a tlv. getTlv() of a message view returns
+ * an invalid view if the tlv is not found.
+ *
+ * @return true if valid.
+ * @return false if not.
+ */
+bool LdpTlvView::valid() const {
+    return _tlv != nullptr;
+}
+
+bool LdpTlvView::unknown() const {
+    return _tlv != nullptr && (_tlv[0] & 0b10000000);
+}
+
+bool LdpTlvView::forwardUnknown() const {
+    return _tlv != nullptr && (_tlv[0] & 0b01000000);
+}
+
+/**
+ * @brief get type field in the tlv.
+ *
+ * @return uint16_t type field in host byte order (u and f bits included).
+ */
+uint16_t LdpTlvView::getType() const {
+    if (_tlv == nullptr) {
+        return 0;
+    }
+
+    uint16_t type;
+    memcpy(&type, _tlv, sizeof(type));
+
+    return ntohs(type);
+}
+
+/**
+ * @brief get length field in the tlv.
+ *
+ * @return uint16_t length field (length of the value) in host byte order.
+ */
+uint16_t LdpTlvView::getLength() const {
+    if (_tlv == nullptr) {
+        return 0;
+    }
+
+    uint16_t len;
+    memcpy(&len, _tlv + sizeof(uint16_t), sizeof(len));
+
+    return ntohs(len);
+}
+
+/**
+ * @brief get the value part of the tlv.
+ *
+ * @return const uint8_t* value, getLength() bytes.
+ */
+const uint8_t* LdpTlvView::getValue() const {
+    if (_tlv == nullptr) {
+        return nullptr;
+    }
+
+    return _tlv + LDP_TLV_HDR_LEN;
+}
+
+/**
+ * @brief get the entire tlv, header included.
+ *
+ * @return const uint8_t* tlv, size() bytes.
+ */
+const uint8_t* LdpTlvView::data() const {
+    return _tlv;
+}
+
+size_t LdpTlvView::size() const {
+    return _len;
+}
+
+/**
+ * @brief get a parsed value object.
+ *
+ * @return LdpTlvValue* parsed value. you must free this yourself after use.
+ * return null if can't be parsed.
+ */
+LdpTlvValue* LdpTlvView::getParsedValue() const {
+    if (_tlv == nullptr) {
+        return nullptr;
+    }
+
+    return LdpRawTlv::parseValue(getType(), getValue(), getLength());
+}
+
+/**
+ * @brief parse the value into the given value object. unlike getParsedValue,
+ * this does not allocate - the object can live on the stack.
+ *
+ * @param into value object. its type must match the type of the tlv.
+ * @param err if not nullptr, set to what went wrong on error. the offset is
+ * from the start of the tlv, header included.
+ * @return ssize_t bytes parsed, or -1 on error.
+ */
+ssize_t LdpTlvView::parseValue(LdpTlvValue &into, LdpParseError *err) const {
+    if (_tlv == nullptr) {
+        return -1;
+    }
+
+    if (getType() != into.getType()) {
+        log_fatal("tlv type (0x%.4x) does not match value type (0x%.4x)\n", getType(), into.getType());
+        return -1;
+    }
+
+    ssize_t ret = into.parse(getValue(), getLength());
+
+    if (ret < 0) {
+        LDP_PARSE_FAIL(err, ParseMalformedValue, LDP_TLV_HDR_LEN);
+    }
+
+    return ret;
+}
+
+LdpTlvIterator::LdpTlvIterator(const uint8_t *at, const uint8_t *end) {
+    _at = at;
+    _end = end;
+}
+
+LdpTlvView LdpTlvIterator::operator*() const {
+    uint16_t len;
+    memcpy(&len, _at + sizeof(uint16_t), sizeof(len));
+
+    return LdpTlvView(_at, LDP_TLV_HDR_LEN + ntohs(len));
+}
+
+LdpTlvIterator& LdpTlvIterator::operator++() {
+    uint16_t len;
+    memcpy(&len, _at + sizeof(uint16_t), sizeof(len));
+
+    _at += LDP_TLV_HDR_LEN + ntohs(len);
+
+    if (_at > _end) {
+        _at = _end;
+    }
+
+    return *this;
+}
+
+bool LdpTlvIterator::operator!=(const LdpTlvIterator &other) const {
+    return _at != other._at;
+}
+
+}
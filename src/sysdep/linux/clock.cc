@@ -0,0 +1,133 @@
+#include "utils/log.hh"
+#include "sysdep/linux/clock.hh"
+
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/timerfd.h>
+
+namespace ldpd {
+
+Clock::Clock() {
+    _fd = -1;
+    _armed = 0;
+}
+
+Clock::~Clock() {
+    close();
+}
+
+/**
+ * @brief create the timerfd.
+ *
+ * @return int status. 0 on success, 1 on error.
+ */
+int Clock::open() {
+    if (_fd >= 0) {
+        log_warn("timerfd already opened.\n");
+        return 0;
+    }
+
+    _fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    if (_fd < 0) {
+        log_fatal("timerfd_create(): %s.\n", strerror(errno));
+        return 1;
+    }
+
+    _armed = 0;
+
+    return 0;
+}
+
+int Clock::close() {
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+
+    return 0;
+}
+
+int Clock::getFd() const {
+    return _fd;
+}
+
+/**
+ * @brief make the timerfd readable at the given time. re-arming for the time
+ * already set is a no-op.
+ *
+ * @param at time, as returned by now(). times in the past fire right away.
+ * @return int status. 0 on success, 1 on error.
+ */
+int Clock::arm(uint64_t at) {
+    if (at == 0) {
+        at = 1;
+    }
+
+    if (at == _armed) {
+        return 0;
+    }
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+
+    spec.it_value.tv_sec = (time_t) (at / 1000);
+    spec.it_value.tv_nsec = (long) (at % 1000) * 1000000;
+
+    if (timerfd_settime(_fd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+        log_error("timerfd_settime(): %s.\n", strerror(errno));
+        return 1;
+    }
+
+    _armed = at;
+
+    return 0;
+}
+
+int Clock::disarm() {
+    if (_armed == 0) {
+        return 0;
+    }
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+
+    if (timerfd_settime(_fd, 0, &spec, nullptr) < 0) {
+        log_error("timerfd_settime(): %s.\n", strerror(errno));
+        return 1;
+    }
+
+    _armed = 0;
+
+    return 0;
+}
+
+/**
+ * @brief consume the expiration after the timerfd became readable.
+ */
+void Clock::ack() {
+    uint64_t expirations;
+
+    if (read(_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+        log_warn("read(): %s.\n", strerror(errno));
+    }
+
+    _armed = 0;
+}
+
+/**
+ * @brief get the time.
+ *
+ * @return uint64_t milliseconds on the monotonic clock.
+ */
+uint64_t Clock::now() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000 + (uint64_t) ts.tv_nsec / 1000000;
+}
+
+}
@@ -0,0 +1,121 @@
+#include "utils/log.hh"
+#include "sysdep/linux/epoll.hh"
+
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+namespace ldpd {
+
+Epoll::Epoll() {
+    _fd = -1;
+}
+
+Epoll::~Epoll() {
+    close();
+}
+
+/**
+ * @brief open the epoll instance.
+ *
+ * @return int status. 0 on success, 1 on error.
+ */
+int Epoll::open() {
+    if (_fd >= 0) {
+        log_warn("epoll instance already opened.\n");
+        return 0;
+    }
+
+    _fd = epoll_create1(EPOLL_CLOEXEC);
+
+    if (_fd < 0) {
+        log_fatal("epoll_create1(): %s.\n", strerror(errno));
+        return 1;
+    }
+
+    return 0;
+}
+
+int Epoll::close() {
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief start watching a fd. the fd itself is handed back in data.fd of the
+ * ready events.
+ *
+ * @param fd fd to watch.
+ * @param events epoll event mask (EPOLLIN, EPOLLOUT, etc.)
+ * @return int status. 0 on success, 1 on error.
+ */
+int Epoll::add(int fd, uint32_t events) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+
+    ev.events = events;
+    ev.data.fd = fd;
+
+    if (epoll_ctl(_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        log_error("epoll_ctl(): add fd %d: %s.\n", fd, strerror(errno));
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief change the event mask of a watched fd.
+ *
+ * @param fd fd being watched.
+ * @param events new epoll event mask.
+ * @return int status. 0 on success, 1 on error.
+ */
+int Epoll::modify(int fd, uint32_t events) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+
+    ev.events = events;
+    ev.data.fd = fd;
+
+    if (epoll_ctl(_fd, EPOLL_CTL_MOD, fd, &ev) < 0) {
+        log_error("epoll_ctl(): mod fd %d: %s.\n", fd, strerror(errno));
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief stop watching a fd. call this before closing the fd.
+ *
+ * @param fd fd being watched.
+ * @return int status. 0 on success, 1 on error.
+ */
+int Epoll::remove(int fd) {
+    if (epoll_ctl(_fd, EPOLL_CTL_DEL, fd, nullptr) < 0) {
+        log_error("epoll_ctl(): del fd %d: %s.\n", fd, strerror(errno));
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief wait for events.
+ *
+ * @param events buffer for ready events.
+ * @param maxEvents size of the events buffer.
+ * @param timeout timeout in milliseconds, -1 to block.
+ * @return int number of ready events, 0 on timeout, or -1 on error (errno is
+ * set).
+ */
+int Epoll::wait(struct epoll_event *events, int maxEvents, int timeout) {
+    return epoll_wait(_fd, events, maxEvents, timeout);
+}
+
+}
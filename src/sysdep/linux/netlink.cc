@@ -1,5 +1,6 @@
 #include "sysdep/linux/netlink.hh"
 #include "sysdep/linux/rtattr.hh"
+#include "utils/label-stack.hh"
 #include <errno.h>
 #include <arpa/inet.h>
 #include <linux/mpls_iptunnel.h>
@@ -84,6 +85,15 @@ int Netlink::close() {
     return 0;
 }
 
+/**
+ * @brief get the rtnl socket fd, for polling change notifications.
+ * 
+ * @return int fd, or -1 if not opened.
+ */
+int Netlink::getFd() const {
+    return _fd;
+}
+
 /**
  * @brief get interfaces. will block.
  * 
@@ -546,9 +556,8 @@ int Netlink::parseNetlinkMessage(Ipv4Route &dst, const struct nlmsghdr *src) {
         return PARSE_SKIP;
     }
 
-    for (size_t i = 0; i < labels_arr_len/sizeof(uint32_t); ++i) {
-        dst.mpls_stack.push_back(ntohl(labels[i]) >> 12);
-    }
+    dst.mpls_stack.resize(labels_arr_len / sizeof(uint32_t));
+    decodeLabelStack(dst.mpls_stack.data(), labels, dst.mpls_stack.size());
 
     mpls_info.getAttributeValue(MPLS_IPTUNNEL_TTL, dst.mpls_ttl);
 
@@ -605,9 +614,8 @@ int Netlink::parseNetlinkMessage(MplsRoute &dst, const struct nlmsghdr *src) {
         return PARSE_SKIP;
     }
 
-    for (size_t i = 0; i < labels_arr_len/sizeof(uint32_t); ++i) {
-        dst.mpls_stack.push_back(ntohl(labels[i]) >> 12);
-    }
+    dst.mpls_stack.resize(labels_arr_len / sizeof(uint32_t));
+    decodeLabelStack(dst.mpls_stack.data(), labels, dst.mpls_stack.size());
 
     return PARSE_OK;
 
@@ -667,12 +675,7 @@ int Netlink::buildRtAttr(const Ipv4Route &route, RtAttr &attrs) {
 
         uint32_t *stack_buf = (uint32_t *) malloc(stack_val_sz);
 
-        int idx = 0;
-        for (const uint32_t &label : route.mpls_stack) {
-            stack_buf[idx++] = htonl(label << 12);
-        }
-
-        stack_buf[idx - 1] |= htonl(0x100);
+        encodeLabelStack(stack_buf, route.mpls_stack.data(), route.mpls_stack.size());
 
         nested.addRawAttribute(MPLS_IPTUNNEL_DST, (uint8_t *) stack_buf, stack_val_sz);
 
@@ -690,12 +693,7 @@ int Netlink::buildRtAttr(const MplsRoute &route, RtAttr &attrs) {
 
         uint32_t *stack_buf = (uint32_t *) malloc(stack_val_sz);
 
-        int idx = 0;
-        for (const uint32_t &label : route.mpls_stack) {
-            stack_buf[idx++] = htonl(label << 12);
-        }
-
-        stack_buf[idx - 1] |= htonl(0x100);
+        encodeLabelStack(stack_buf, route.mpls_stack.data(), route.mpls_stack.size());
 
         attrs.addRawAttribute(RTA_NEWDST, (uint8_t *) stack_buf, stack_val_sz);
 
@@ -0,0 +1,137 @@
+#include "utils/label-stack.hh"
+
+#include <string.h>
+#include <arpa/inet.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#define LDP_LABEL_STACK_SSSE3
+#endif
+
+#define LDP_LABEL_SHIFT 12
+#define LDP_LABEL_BOS 0x100
+
+// shorter stacks (the usual case) are done faster by the scalar loop than by
+// the feature check and the vector setup.
+#define LDP_LABEL_STACK_SIMD_MIN 8
+
+namespace ldpd {
+
+static inline void encodeEntries(uint32_t *to, const uint32_t *labels, size_t from, size_t count) {
+    for (size_t i = from; i < count; ++i) {
+        to[i] = htonl(labels[i] << LDP_LABEL_SHIFT);
+    }
+}
+
+static inline void decodeEntries(uint32_t *labels, const uint8_t *from, size_t start, size_t count) {
+    for (size_t i = start; i < count; ++i) {
+        uint32_t entry;
+        memcpy(&entry, from + i * sizeof(uint32_t), sizeof(entry));
+
+        labels[i] = ntohl(entry) >> LDP_LABEL_SHIFT;
+    }
+}
+
+void encodeLabelStackScalar(uint32_t *to, const uint32_t *labels, size_t count) {
+    encodeEntries(to, labels, 0, count);
+
+    if (count > 0) {
+        to[count - 1] |= htonl(LDP_LABEL_BOS);
+    }
+}
+
+void decodeLabelStackScalar(uint32_t *labels, const void *from, size_t count) {
+    decodeEntries(labels, (const uint8_t *) from, 0, count);
+}
+
+#ifdef LDP_LABEL_STACK_SSSE3
+
+// four entries at a time: shift, then byte-swap each 32-bit lane w/ a single
+// shuffle. the tail is left to the scalar code.
+
+__attribute__((target("ssse3"))) static size_t encodeLabelStackSsse3(uint32_t *to, const uint32_t *labels, size_t count) {
+    const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (labels + i));
+        v = _mm_slli_epi32(v, LDP_LABEL_SHIFT);
+        v = _mm_shuffle_epi8(v, bswap);
+        _mm_storeu_si128((__m128i *) (to + i), v);
+    }
+
+    return i;
+}
+
+__attribute__((target("ssse3"))) static size_t decodeLabelStackSsse3(uint32_t *labels, const uint8_t *from, size_t count) {
+    const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (from + i * sizeof(uint32_t)));
+        v = _mm_shuffle_epi8(v, bswap);
+        v = _mm_srli_epi32(v, LDP_LABEL_SHIFT);
+        _mm_storeu_si128((__m128i *) (labels + i), v);
+    }
+
+    return i;
+}
+
+static bool haveSsse3() {
+    static int have = -1;
+
+    if (have < 0) {
+        __builtin_cpu_init();
+        have = __builtin_cpu_supports("ssse3") ? 1 : 0;
+    }
+
+    return have == 1;
+}
+
+#endif
+
+/**
+ * @brief encode a label stack.
+ *
+ * @param to where to write count entries.
+ * @param labels labels, top of the stack first.
+ * @param count number of labels.
+ */
+void encodeLabelStack(uint32_t *to, const uint32_t *labels, size_t count) {
+    size_t done = 0;
+
+#ifdef LDP_LABEL_STACK_SSSE3
+    if (count >= LDP_LABEL_STACK_SIMD_MIN && haveSsse3()) {
+        done = encodeLabelStackSsse3(to, labels, count);
+    }
+#endif
+
+    encodeEntries(to, labels, done, count);
+
+    if (count > 0) {
+        to[count - 1] |= htonl(LDP_LABEL_BOS);
+    }
+}
+
+/**
+ * @brief decode a label stack. the caller checks the size of the source; tc,
+ * ttl and bos bits are dropped.
+ *
+ * @param labels where to write count labels.
+ * @param from label stack entries, need not be aligned.
+ * @param count number of entries.
+ */
+void decodeLabelStack(uint32_t *labels, const void *from, size_t count) {
+    const uint8_t *ptr = (const uint8_t *) from;
+    size_t done = 0;
+
+#ifdef LDP_LABEL_STACK_SSSE3
+    if (count >= LDP_LABEL_STACK_SIMD_MIN && haveSsse3()) {
+        done = decodeLabelStackSsse3(labels, ptr, count);
+    }
+#endif
+
+    decodeEntries(labels, ptr, done, count);
+}
+
+}
@@ -0,0 +1,48 @@
+#include "utils/log-limiter.hh"
+
+namespace ldpd {
+
+LogLimiter::LogLimiter(uint32_t burst, uint64_t interval) {
+    _burst = burst;
+    _interval = interval;
+    _start = 0;
+    _count = 0;
+    _suppressed = 0;
+}
+
+/**
+ * @brief test if a message may be logged now. counts it as suppressed if not.
+ *
+ * @param now time now, ms on the monotonic clock.
+ * @return true if the message should be logged.
+ * @return false if it should be dropped.
+ */
+bool LogLimiter::allow(uint64_t now) {
+    if (_count == 0 || now - _start >= _interval) {
+        _start = now;
+        _count = 0;
+    }
+
+    if (_count >= _burst) {
+        ++_suppressed;
+        return false;
+    }
+
+    ++_count;
+
+    return true;
+}
+
+/**
+ * @brief get the number of messages dropped since the last call.
+ *
+ * @return uint32_t messages dropped.
+ */
+uint32_t LogLimiter::takeSuppressed() {
+    uint32_t suppressed = _suppressed;
+    _suppressed = 0;
+
+    return suppressed;
+}
+
+}
@@ -0,0 +1,14 @@
+#ifndef LDP_BENCH_CLOCK_H
+#define LDP_BENCH_CLOCK_H
+#include <stdint.h>
+#include <time.h>
+
+// monotonic time in ns, for the timing loops of the benchmarks.
+static inline uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+#endif // LDP_BENCH_CLOCK_H
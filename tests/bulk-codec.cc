@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <vector>
+#include "utils/label-stack.hh"
+#include "ldp-tlv/ldp-address-tlv-value.hh"
+#include "bench-clock.hh"
+
+#define ROUNDS 200000
+
+// what the label stack code did before: one entry at a time. not inlined, so
+// it pays a call like the library does.
+__attribute__((noinline)) static void encode_per_entry(uint32_t *to, const uint32_t *labels, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        to[i] = htonl(labels[i] << 12);
+    }
+
+    to[count - 1] |= htonl(0x100);
+}
+
+// what the address list parser did before: bounds check + copy per address.
+static ssize_t parse_per_address(std::vector<uint32_t> &to, const uint8_t *from, size_t len) {
+    const uint8_t *ptr = from + sizeof(uint16_t);
+    size_t remaining = len - sizeof(uint16_t);
+
+    while (remaining > 0) {
+        if (remaining < sizeof(uint32_t)) {
+            return -1;
+        }
+
+        uint32_t addr;
+        memcpy(&addr, ptr, sizeof(addr));
+        to.push_back(addr);
+
+        ptr += sizeof(uint32_t);
+        remaining -= sizeof(uint32_t);
+    }
+
+    return ptr - from;
+}
+
+// vector and scalar paths must agree, for every length and alignment.
+int check_label_stack() {
+    uint32_t labels[33], a[33], b[33], back[33];
+    uint8_t unaligned[33 * sizeof(uint32_t) + 1];
+
+    for (size_t i = 0; i < 33; ++i) {
+        labels[i] = (i * 40503 + 16) & 0xfffff;
+    }
+
+    for (size_t n = 1; n <= 33; ++n) {
+        ldpd::encodeLabelStackScalar(a, labels, n);
+        ldpd::encodeLabelStack(b, labels, n);
+
+        if (memcmp(a, b, n * sizeof(uint32_t)) != 0) {
+            printf("encode: vector and scalar differ at %zu labels.\n", n);
+            return 1;
+        }
+
+        memcpy(unaligned + 1, b, n * sizeof(uint32_t));
+        ldpd::decodeLabelStack(back, unaligned + 1, n);
+
+        if (memcmp(back, labels, n * sizeof(uint32_t)) != 0) {
+            printf("decode: did not get labels back at %zu labels.\n", n);
+            return 1;
+        }
+    }
+
+    printf("label stack: test passed.\n");
+
+    return 0;
+}
+
+int bench_label_stack(size_t n) {
+    uint32_t labels[16], out[16];
+    uint64_t sink = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        labels[i] = 16 + i;
+    }
+
+    uint64_t start = now_ns();
+
+    for (size_t r = 0; r < ROUNDS; ++r) {
+        labels[0] = r & 0xfffff;
+        encode_per_entry(out, labels, n);
+        sink += out[n - 1];
+    }
+
+    uint64_t scalar = now_ns() - start;
+
+    start = now_ns();
+
+    for (size_t r = 0; r < ROUNDS; ++r) {
+        labels[0] = r & 0xfffff;
+        ldpd::encodeLabelStack(out, labels, n);
+        sink += out[n - 1];
+    }
+
+    uint64_t bulk = now_ns() - start;
+
+    printf("label stack encode, %2zu labels: per-entry %6.1f ns, bulk %6.1f ns (%lu)\n", n, (double) scalar / ROUNDS, (double) bulk / ROUNDS, sink & 1);
+
+    return 0;
+}
+
+int bench_address_list(size_t n) {
+    std::vector<uint8_t> tlv(sizeof(uint16_t) + n * sizeof(uint32_t));
+    uint16_t af = htons(1);
+
+    memcpy(tlv.data(), &af, sizeof(af));
+
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t addr = htonl(0x0a000000 + i);
+        memcpy(tlv.data() + sizeof(uint16_t) + i * sizeof(uint32_t), &addr, sizeof(addr));
+    }
+
+    size_t rounds = ROUNDS / 10;
+    uint64_t sink = 0;
+    uint64_t start = now_ns();
+
+    for (size_t r = 0; r < rounds; ++r) {
+        std::vector<uint32_t> addrs;
+        sink += parse_per_address(addrs, tlv.data(), tlv.size());
+    }
+
+    uint64_t scalar = now_ns() - start;
+
+    start = now_ns();
+
+    for (size_t r = 0; r < rounds; ++r) {
+        ldpd::LdpAddressTlvValue val = ldpd::LdpAddressTlvValue();
+        sink += val.parse(tlv.data(), tlv.size());
+    }
+
+    uint64_t bulk = now_ns() - start;
+
+    ldpd::LdpAddressTlvValue val = ldpd::LdpAddressTlvValue();
+
+    if (val.parse(tlv.data(), tlv.size()) != (ssize_t) tlv.size() || val.getAddresses().size() != n) {
+        printf("address list: bad parse.\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> wb(val.length());
+
+    if (val.write(wb.data(), wb.size()) != (ssize_t) tlv.size() || memcmp(wb.data(), tlv.data(), tlv.size()) != 0) {
+        printf("address list: writeback differs.\n");
+        return 1;
+    }
+
+    printf("address list parse, %4zu addrs: per-address %8.1f ns, bulk %8.1f ns (%lu)\n", n, (double) scalar / rounds, (double) bulk / rounds, sink & 1);
+
+    return 0;
+}
+
+int main() {
+    if (check_label_stack() != 0) {
+        return 1;
+    }
+
+    bench_label_stack(1);
+    bench_label_stack(3);
+    bench_label_stack(8);
+    bench_label_stack(16);
+
+    if (bench_address_list(4) != 0 || bench_address_list(64) != 0 || bench_address_list(1024) != 0) {
+        return 1;
+    }
+
+    return 0;
+}
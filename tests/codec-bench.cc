@@ -0,0 +1,368 @@
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <vector>
+#include "core/arena.hh"
+#include "ldp-pdu/ldp-pdu.hh"
+#include "ldp-pdu/ldp-pdu-view.hh"
+#include "ldp-pdu/ldp-pdu-writer.hh"
+#include "ldp-tlv/ldp-tlv.hh"
+#include "bench-clock.hh"
+
+// codec benchmark: parse and write realistic pdus w/ each of the codec paths,
+// and report time and heap allocations per pdu. run it before and after a
+// codec change to see what it did.
+//
+// the paths:
+// - view: LdpPduView::parse, then walk every message and tlv (what the
+//   session receive path does before handling a message),
+// - parse: LdpPdu::parse, then decode every tlv value (getCachedValue), heap,
+// - arena: same, but the pdu lives in an arena that is reset after each pdu,
+// - write: LdpPdu::write of the parsed pdu,
+// - writer: re-encode the pdu w/ LdpPduWriter, copying tlvs as they are.
+
+// number of bytes to go through per case - enough to get stable numbers.
+#define BENCH_BYTES 20000000
+
+#define BENCH_ROUTER_ID 0x0106060a
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t n, size_t size);
+extern "C" void* __libc_realloc(void *ptr, size_t size);
+
+static size_t allocations = 0;
+
+// count every heap allocation: operator new, arena blocks and tlv buffers all
+// end up here.
+extern "C" void* malloc(size_t size) {
+    ++allocations;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t n, size_t size) {
+    ++allocations;
+    return __libc_calloc(n, size);
+}
+
+extern "C" void* realloc(void *ptr, size_t size) {
+    ++allocations;
+    return __libc_realloc(ptr, size);
+}
+
+typedef size_t (*BenchFn)(const uint8_t *pdu, size_t len, uint8_t *scratch);
+
+static size_t bench_view(const uint8_t *pdu, size_t len, uint8_t *) {
+    ldpd::LdpPduView view = ldpd::LdpPduView();
+
+    if (view.parse(pdu, len) < 0) {
+        return 0;
+    }
+
+    size_t tlvs = 0;
+
+    for (const ldpd::LdpMessageView msg : view) {
+        for (const ldpd::LdpTlvView tlv : msg) {
+            tlvs += tlv.getType();
+        }
+    }
+
+    return tlvs;
+}
+
+// decode every tlv value (unknown ones stay undecoded). returns number of
+// tlvs seen.
+static size_t decode_values(const ldpd::LdpPdu &parsed) {
+    size_t tlvs = 0;
+
+    for (const ldpd::LdpMessage *msg : parsed.getMessages()) {
+        for (const ldpd::LdpRawTlv *tlv : msg->getTlvs()) {
+            tlv->getCachedValue();
+            ++tlvs;
+        }
+    }
+
+    return tlvs;
+}
+
+static size_t bench_parse(const uint8_t *pdu, size_t len, uint8_t *) {
+    ldpd::LdpPdu parsed = ldpd::LdpPdu();
+
+    if (parsed.parse(pdu, len) < 0) {
+        return 0;
+    }
+
+    return decode_values(parsed);
+}
+
+static ldpd::Arena arena;
+
+static size_t bench_arena(const uint8_t *pdu, size_t len, uint8_t *) {
+    size_t tlvs = 0;
+
+    {
+        ldpd::LdpPdu parsed = ldpd::LdpPdu(&arena);
+
+        if (parsed.parse(pdu, len) >= 0) {
+            tlvs = decode_values(parsed);
+        }
+    }
+
+    arena.reset();
+
+    return tlvs;
+}
+
+// the pdu to write, parsed once up front.
+static ldpd::LdpPdu *to_write = nullptr;
+
+static size_t bench_write(const uint8_t *, size_t len, uint8_t *scratch) {
+    ssize_t written = to_write->write(scratch, len);
+
+    return written < 0 ? 0 : written;
+}
+
+static size_t bench_writer(const uint8_t *pdu, size_t len, uint8_t *scratch) {
+    ldpd::LdpPduView view = ldpd::LdpPduView();
+
+    if (view.parse(pdu, len) < 0) {
+        return 0;
+    }
+
+    ldpd::LdpPduWriter writer = ldpd::LdpPduWriter(scratch, len);
+
+    writer.begin(view.getRouterId(), view.getLabelSpace());
+
+    for (const ldpd::LdpMessageView msg : view) {
+        writer.beginMessage(msg.getType(), msg.getId());
+
+        for (const ldpd::LdpTlvView tlv : msg) {
+            writer.addRawTlv(tlv.data(), tlv.size());
+        }
+
+        writer.endMessage();
+    }
+
+    ssize_t written = writer.end();
+
+    return written < 0 ? 0 : written;
+}
+
+static int run(const char *name, const std::vector<uint8_t> &pdu) {
+    struct {
+        const char *name;
+        BenchFn fn;
+    } paths[] = {
+        { "view", bench_view }, { "parse", bench_parse }, { "arena", bench_arena }, { "write", bench_write }, { "writer", bench_writer }
+    };
+
+    std::vector<uint8_t> scratch(pdu.size());
+
+    to_write = new ldpd::LdpPdu();
+
+    if (to_write->parse(pdu.data(), pdu.size()) != (ssize_t) pdu.size()) {
+        printf("%s: can not parse the pdu.\n", name);
+        return 1;
+    }
+
+    if (bench_writer(pdu.data(), pdu.size(), scratch.data()) != pdu.size() || memcmp(scratch.data(), pdu.data(), pdu.size()) != 0) {
+        printf("%s: writer output differs from the input.\n", name);
+        return 1;
+    }
+
+    size_t rounds = BENCH_BYTES / pdu.size() + 100;
+
+    printf("%-20s %5zu bytes:", name, pdu.size());
+
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); ++i) {
+        size_t sink = 0;
+
+        // warm up: first-use allocations (e.g. arena blocks) are not counted.
+        for (size_t r = 0; r < 100; ++r) {
+            sink += paths[i].fn(pdu.data(), pdu.size(), scratch.data());
+        }
+
+        size_t allocs = allocations;
+        uint64_t start = now_ns();
+
+        for (size_t r = 0; r < rounds; ++r) {
+            sink += paths[i].fn(pdu.data(), pdu.size(), scratch.data());
+        }
+
+        uint64_t elapsed = now_ns() - start;
+        allocs = allocations - allocs;
+
+        if (sink == 0) {
+            printf("\n%s: %s failed.\n", name, paths[i].name);
+            return 1;
+        }
+
+        printf("  %s %8.1f ns %6.1f al", paths[i].name, (double) elapsed / rounds, (double) allocs / rounds);
+    }
+
+    printf("\n");
+
+    delete to_write;
+    to_write = nullptr;
+
+    return 0;
+}
+
+// pdus are built w/ the writer - what the daemon sends is what it receives.
+
+static std::vector<uint8_t> finish(ldpd::LdpPduWriter &writer, std::vector<uint8_t> &buffer) {
+    ssize_t len = writer.end();
+
+    buffer.resize(len < 0 ? 0 : len);
+
+    return buffer;
+}
+
+static std::vector<uint8_t> make_hello() {
+    std::vector<uint8_t> buffer(LDP_PDU_MAX_LEN);
+    ldpd::LdpPduWriter writer = ldpd::LdpPduWriter(buffer.data(), buffer.size());
+
+    writer.begin(BENCH_ROUTER_ID, 0);
+    writer.beginMessage(LDP_MSGTYPE_HELLO, 1);
+
+    // hold time 15, no t/r bits.
+    writer.beginTlv(LDP_TLVTYPE_COMMON_HELLO);
+    writer.putU16(15);
+    writer.putU16(0);
+    writer.endTlv();
+
+    writer.beginTlv(LDP_TLVTYPE_IPV4_TRANSPORT);
+    writer.putU32(0x0a060601);
+    writer.endTlv();
+
+    writer.beginTlv(LDP_TLVTYPE_CONFIGURATION_SEQ);
+    writer.putU32(1);
+    writer.endTlv();
+
+    writer.endMessage();
+
+    return finish(writer, buffer);
+}
+
+static std::vector<uint8_t> make_init() {
+    std::vector<uint8_t> buffer(LDP_PDU_MAX_LEN);
+    ldpd::LdpPduWriter writer = ldpd::LdpPduWriter(buffer.data(), buffer.size());
+
+    ldpd::LdpCommonSessionParamsTlvValue params = ldpd::LdpCommonSessionParamsTlvValue();
+    params.setProtocolVersion(LDP_VERSION);
+    params.setKeepaliveTime(180);
+    params.setMaxPduLength(LDP_DEF_MAX_PDU_LEN);
+    params.setReceiverRouterId(0x0206060a);
+    params.setReceiverLabelSpace(0);
+
+    writer.begin(BENCH_ROUTER_ID, 0);
+    writer.beginMessage(LDP_MSGTYPE_INITIALIZE, 1);
+    writer.addTlv(params);
+    writer.endMessage();
+
+    return finish(writer, buffer);
+}
+
+static std::vector<uint8_t> make_addresses(size_t n) {
+    std::vector<uint8_t> buffer(LDP_PDU_MAX_LEN);
+    ldpd::LdpPduWriter writer = ldpd::LdpPduWriter(buffer.data(), buffer.size());
+
+    std::vector<uint32_t> addrs(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        addrs[i] = htonl(0x0a000000 + i);
+    }
+
+    ldpd::LdpAddressTlvValue addr_val = ldpd::LdpAddressTlvValue();
+    addr_val.addAddresses(addrs.data(), n);
+
+    writer.begin(BENCH_ROUTER_ID, 0);
+    writer.beginMessage(LDP_MSGTYPE_ADDRESS, 1);
+    writer.addTlv(addr_val);
+    writer.endMessage();
+
+    return finish(writer, buffer);
+}
+
+// a mapping burst: one label mapping message per fec, as sent on session up.
+static std::vector<uint8_t> make_mappings(size_t n) {
+    std::vector<uint8_t> buffer(LDP_PDU_MAX_LEN);
+    ldpd::LdpPduWriter writer = ldpd::LdpPduWriter(buffer.data(), buffer.size());
+
+    writer.begin(BENCH_ROUTER_ID, 0);
+
+    for (size_t i = 0; i < n; ++i) {
+        writer.beginMessage(LDP_MSGTYPE_LABEL_MAPPING, i + 1);
+
+        // one /24 prefix element.
+        writer.beginTlv(LDP_TLVTYPE_FEC);
+        writer.putU8(LDP_FEC_PREFIX);
+        writer.putU16(1);
+        writer.putU8(24);
+        writer.putU16(0x0a00 + (i >> 8));
+        writer.putU8(i & 0xff);
+        writer.endTlv();
+
+        writer.beginTlv(LDP_TLVTYPE_GENERIC_LABEL);
+        writer.putU32(16 + i);
+        writer.endTlv();
+
+        writer.endMessage();
+    }
+
+    return finish(writer, buffer);
+}
+
+static std::vector<uint8_t> make_notification() {
+    std::vector<uint8_t> buffer(LDP_PDU_MAX_LEN);
+    ldpd::LdpPduWriter writer = ldpd::LdpPduWriter(buffer.data(), buffer.size());
+
+    ldpd::LdpStatusTlvValue status = ldpd::LdpStatusTlvValue();
+    status.setStatusCode(LDP_SC_SHUTDOWN);
+
+    writer.begin(BENCH_ROUTER_ID, 0);
+    writer.beginMessage(LDP_MSGTYPE_NOTIFICATION, 1);
+    writer.addTlv(status);
+    writer.endMessage();
+
+    return finish(writer, buffer);
+}
+
+// a keepalive carrying tlvs we don't know (u bit set: ignore them).
+static std::vector<uint8_t> make_unknown_tlvs(size_t n) {
+    std::vector<uint8_t> buffer(LDP_PDU_MAX_LEN);
+    ldpd::LdpPduWriter writer = ldpd::LdpPduWriter(buffer.data(), buffer.size());
+
+    writer.begin(BENCH_ROUTER_ID, 0);
+    writer.beginMessage(LDP_MSGTYPE_KEEPALIVE, 1);
+
+    for (size_t i = 0; i < n; ++i) {
+        writer.beginTlv(0x8f00 + i);
+        writer.putU32(i);
+        writer.putU32(~i);
+        writer.endTlv();
+    }
+
+    writer.endMessage();
+
+    return finish(writer, buffer);
+}
+
+int main() {
+    if (run("hello", make_hello()) != 0 || run("init", make_init()) != 0 || run("notification", make_notification()) != 0) {
+        return 1;
+    }
+
+    if (run("addresses x16", make_addresses(16)) != 0 || run("addresses x256", make_addresses(256)) != 0) {
+        return 1;
+    }
+
+    if (run("mappings x16", make_mappings(16)) != 0 || run("mappings x128", make_mappings(128)) != 0) {
+        return 1;
+    }
+
+    if (run("unknown tlvs x8", make_unknown_tlvs(8)) != 0) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <arpa/inet.h>
+#include "core/label-allocator.hh"
+#include "core/mapping-db.hh"
+#include "bench-clock.hh"
+
+#define PEERS 8
+#define FECS 20000
+
+// core benchmark: time the daemon's data structures at full-table sizes.
+// the behaviour is checked by the unit tests; this only reports how long
+// things take.
+
+// allocating the full label space should take the same time per label at
+// the end as at the start.
+int bench_allocate() {
+    ldpd::LabelAllocator labels = ldpd::LabelAllocator();
+    size_t count = LDP_MAX_LBL - LDP_MIN_LBL + 1;
+
+    uint64_t start = now_ns();
+
+    for (size_t i = 0; i < count; ++i) {
+        if (labels.allocate() != LDP_MIN_LBL + i) {
+            printf("allocate: bad label at %zu.\n", i);
+            return 1;
+        }
+    }
+
+    uint64_t elapsed = now_ns() - start;
+
+    for (uint32_t label = LDP_MIN_LBL; label <= LDP_MAX_LBL; label += 2) {
+        labels.release(label);
+    }
+
+    printf("allocate %zu labels: %.1f ns per label, %zu left after releasing half.\n", count, (double) elapsed / count, labels.available());
+
+    return 0;
+}
+
+static ldpd::LdpLabelMapping make_mapping(uint32_t n, uint32_t out_label) {
+    ldpd::LdpLabelMapping mapping = ldpd::LdpLabelMapping();
+
+    mapping.remote = true;
+    mapping.fec = ldpd::Prefix(htonl(0x0a000000 + (n << 8)), 24);
+    mapping.out_label = out_label;
+
+    return mapping;
+}
+
+// add and find the bindings of a few peers w/ a full table each.
+int bench_find() {
+    ldpd::MappingDb db = ldpd::MappingDb();
+    uint64_t start = now_ns();
+
+    for (uint32_t peer = 1; peer <= PEERS; ++peer) {
+        for (uint32_t n = 0; n < FECS; ++n) {
+            db.update(peer, make_mapping(n, 100 + n));
+        }
+    }
+
+    uint64_t add = now_ns() - start;
+    uint64_t sink = 0;
+
+    start = now_ns();
+
+    for (uint32_t peer = 1; peer <= PEERS; ++peer) {
+        for (uint32_t n = 0; n < FECS; ++n) {
+            sink += db.find(peer, make_mapping(n, 0).fec)->out_label;
+        }
+    }
+
+    uint64_t find = now_ns() - start;
+
+    printf("%u bindings: add %.1f ns, find %.1f ns per binding (%lu)\n", PEERS * FECS, (double) add / (PEERS * FECS), (double) find / (PEERS * FECS), sink & 1);
+
+    return 0;
+}
+
+int main() {
+    if (bench_allocate() != 0) {
+        return 1;
+    }
+
+    return bench_find();
+}
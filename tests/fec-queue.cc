@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <arpa/inet.h>
+#include "core/fec-queue.hh"
+
+static ldpd::Prefix make_fec(uint32_t n) {
+    return ldpd::Prefix(htonl(0x0a000000 + (n << 8)), 24);
+}
+
+// fecs come out in the order they were first pushed, once each.
+int check_order() {
+    ldpd::FecQueue queue = ldpd::FecQueue();
+
+    for (uint32_t round = 0; round < 3; ++round) {
+        for (uint32_t n = 0; n < 100; ++n) {
+            if (queue.push(make_fec(n)) != (round == 0)) {
+                printf("order: push of a queued fec should do nothing.\n");
+                return 1;
+            }
+        }
+    }
+
+    if (queue.size() != 100) {
+        printf("order: want 100 fecs, got %zu.\n", queue.size());
+        return 1;
+    }
+
+    for (uint32_t n = 0; n < 100; ++n) {
+        if (!(queue.front() == make_fec(n))) {
+            printf("order: fec %u out of order.\n", n);
+            return 1;
+        }
+
+        queue.pop();
+
+        if (queue.contains(make_fec(n))) {
+            printf("order: fec %u still queued after pop.\n", n);
+            return 1;
+        }
+    }
+
+    // popped fecs can be queued again.
+    if (!queue.empty() || !queue.push(make_fec(0)) || queue.size() != 1) {
+        printf("order: bad state after draining.\n");
+        return 1;
+    }
+
+    printf("order: test passed.\n");
+
+    return 0;
+}
+
+int main() {
+    return check_order();
+}
@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include "core/label-allocator.hh"
+
+// lowest free label first, released labels are reused, reserved blocks are
+// skipped.
+int check_allocate() {
+    ldpd::LabelAllocator labels = ldpd::LabelAllocator(16, 16 + 200);
+
+    if (labels.reserve(20, 10) != 0 || labels.reserve(25, 1) == 0) {
+        printf("reserve: bad result.\n");
+        return 1;
+    }
+
+    for (uint32_t want = 16; want <= 216; ++want) {
+        if (want >= 20 && want < 30) {
+            continue;
+        }
+
+        uint32_t got = labels.allocate();
+
+        if (got != want) {
+            printf("allocate: want %u, got %u.\n", want, got);
+            return 1;
+        }
+    }
+
+    if (labels.allocate() != LDP_LABEL_NONE || labels.available() != 0) {
+        printf("allocate: range should be used up.\n");
+        return 1;
+    }
+
+    if (labels.release(150) != 0 || labels.release(100) != 0 || labels.release(100) == 0 || labels.release(22) == 0) {
+        printf("release: bad result.\n");
+        return 1;
+    }
+
+    if (labels.allocate() != 100 || labels.allocate() != 150) {
+        printf("allocate: released labels not reused lowest first.\n");
+        return 1;
+    }
+
+    if (labels.unreserve(20, 10) != 0 || labels.allocate() != 20) {
+        printf("unreserve: block not given back.\n");
+        return 1;
+    }
+
+    printf("test passed.\n");
+
+    return 0;
+}
+
+int main() {
+    if (check_allocate() != 0) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,369 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <vector>
+#include "core/ldpd.hh"
+#include "ldp-fsm/ldp-fsm.hh"
+#include "ldp-fsm/ldp-pdu-packer.hh"
+#include "ldp-pdu/ldp-pdu-view.hh"
+#include "ldp-tlv/ldp-tlv.hh"
+#include "ldp-tlv/ldp-fec-view.hh"
+
+// smallest max pdu length a peer may negotiate - anything less means the
+// default (rfc5036 3.5.3).
+#define MAX_PDU (LDP_MAX_PDU_LEN_USE_DEF + 1)
+
+#define MAPPINGS 100
+#define ADDRESSES 300
+
+// a router w/ nothing on it - the packer tests do not install routes.
+class NullRouter : public ldpd::Router {
+public:
+    std::vector<ldpd::Interface> getInterfaces() { return std::vector<ldpd::Interface>(); }
+    std::vector<const ldpd::Route *> getFib() { return std::vector<const ldpd::Route *>(); }
+    std::vector<const ldpd::Route *> getRoutes() { return std::vector<const ldpd::Route *>(); }
+
+    const ldpd::Ipv4Route* findIpv4Route(const ldpd::Prefix &) { return nullptr; }
+    const ldpd::MplsRoute* findMplsRoute(uint32_t) { return nullptr; }
+
+    uint64_t addRoute(ldpd::Route *route) { delete route; return 0; }
+    bool deleteRoute(const ldpd::Route *) { return false; }
+
+    void onRouteChange(void *, ldpd::ldp_routechange_handler_t) {}
+
+    int getFd() const { return -1; }
+
+    void tick() {}
+};
+
+// a message w/ a tlv bigger than any pdu we may send.
+static ssize_t encode_oversized(void *, ldpd::LdpPduWriter &writer) {
+    uint8_t payload[MAX_PDU];
+    memset(payload, 0, sizeof(payload));
+
+    writer.beginMessage(LDP_MSGTYPE_LABEL_MAPPING, 1);
+    writer.beginTlv(LDP_TLVTYPE_FEC);
+    writer.put(payload, sizeof(payload));
+    writer.endTlv();
+
+    return writer.endMessage();
+}
+
+// write out what is queued for the session and read it back.
+static int drain(ldpd::LdpFsm &session, std::vector<uint8_t> &into) {
+    int sv[2];
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+        printf("socketpair(): %s.\n", strerror(errno));
+        return 1;
+    }
+
+    into.clear();
+
+    ssize_t len = session.getSendQueue().flush(sv[0]);
+    close(sv[0]);
+
+    uint8_t buffer[4096];
+    ssize_t got;
+
+    while ((got = read(sv[1], buffer, sizeof(buffer))) > 0) {
+        into.insert(into.end(), buffer, buffer + got);
+    }
+
+    close(sv[1]);
+
+    if (len < 0 || (size_t) len != into.size() || session.getSendQueue().pending() != 0) {
+        printf("drain: queued %zd bytes, read back %zu.\n", len, into.size());
+        return 1;
+    }
+
+    return 0;
+}
+
+// parse the pdus in the buffer, check their size, and hand every message to
+// the callback. returns number of pdus, or -1 on error.
+template <typename F> static int walk(const std::vector<uint8_t> &buffer, F on_message) {
+    size_t offset = 0;
+    int pdus = 0;
+
+    while (offset < buffer.size()) {
+        ldpd::LdpPduView pdu = ldpd::LdpPduView();
+        ssize_t len = pdu.parse(buffer.data() + offset, buffer.size() - offset);
+
+        if (len < 0) {
+            printf("walk: bad pdu at offset %zu.\n", offset);
+            return -1;
+        }
+
+        // the length field does not count the version and length itself.
+        if (pdu.getLength() > MAX_PDU || (size_t) len > MAX_PDU + LDP_PDU_HDR_LEN) {
+            printf("walk: pdu of %u bytes, max is %u.\n", pdu.getLength(), MAX_PDU);
+            return -1;
+        }
+
+        size_t messages = 0;
+
+        for (const ldpd::LdpMessageView msg : pdu) {
+            if (on_message(msg) != 0) {
+                return -1;
+            }
+
+            ++messages;
+        }
+
+        if (messages == 0) {
+            printf("walk: empty pdu.\n");
+            return -1;
+        }
+
+        offset += len;
+        ++pdus;
+    }
+
+    return pdus;
+}
+
+// mappings spread over pdus no bigger than the max pdu length, each exactly
+// once, none lost at a pdu boundary.
+int check_mappings(ldpd::Ldpd &ldpd) {
+    ldpd::LdpFsm session = ldpd::LdpFsm(&ldpd);
+    ldpd::LdpPduPacker packer = ldpd::LdpPduPacker(&session);
+
+    std::vector<ldpd::LdpLabelMapping> mappings = std::vector<ldpd::LdpLabelMapping>(MAPPINGS);
+
+    for (uint32_t i = 0; i < MAPPINGS; ++i) {
+        mappings[i].fec = ldpd::Prefix(htonl(0x0a000000 + (i << 8)), 24);
+        mappings[i].in_label = 1000 + i;
+
+        ldpd::LdpMappingAdvertisement advert;
+
+        advert.ldpd = &ldpd;
+        advert.mapping = &mappings[i];
+
+        if (packer.add(ldpd::Ldpd::encodeMapping, &advert) < 0) {
+            printf("mappings: add %u failed.\n", i);
+            return 1;
+        }
+    }
+
+    if (packer.flush() < 0 || packer.messages() != MAPPINGS) {
+        printf("mappings: flush failed.\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> buffer;
+
+    if (drain(session, buffer) != 0) {
+        return 1;
+    }
+
+    std::vector<int> seen = std::vector<int>(MAPPINGS, 0);
+
+    int pdus = walk(buffer, [&](const ldpd::LdpMessageView &msg) {
+        ldpd::LdpTlvView fec = msg.getTlv(LDP_TLVTYPE_FEC);
+        ldpd::LdpTlvView lbl = msg.getTlv(LDP_TLVTYPE_GENERIC_LABEL);
+        ldpd::LdpGenericLabelTlvValue lbl_val = ldpd::LdpGenericLabelTlvValue();
+
+        if (msg.getType() != LDP_MSGTYPE_LABEL_MAPPING || !fec.valid() || !lbl.valid() || lbl.parseValue(lbl_val) < 0) {
+            printf("mappings: bad message.\n");
+            return 1;
+        }
+
+        ldpd::LdpFecView elements = ldpd::LdpFecView(fec);
+        uint8_t type, len;
+        uint32_t prefix;
+
+        if (elements.next(type, prefix, len) <= 0) {
+            printf("mappings: no fec element.\n");
+            return 1;
+        }
+
+        uint32_t i = (ntohl(prefix) - 0x0a000000) >> 8;
+
+        if (i >= MAPPINGS || len != 24 || lbl_val.getLabel() != 1000 + i) {
+            printf("mappings: unexpected fec / label.\n");
+            return 1;
+        }
+
+        ++seen[i];
+
+        return 0;
+    });
+
+    if (pdus < 0) {
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < MAPPINGS; ++i) {
+        if (seen[i] != 1) {
+            printf("mappings: fec %u seen %d times.\n", i, seen[i]);
+            return 1;
+        }
+    }
+
+    if ((size_t) pdus != packer.pdus() || pdus < 2) {
+        printf("mappings: %d pdus on the wire, packer says %zu.\n", pdus, packer.pdus());
+        return 1;
+    }
+
+    printf("mappings: %u mappings in %d pdus, test passed.\n", MAPPINGS, pdus);
+
+    return 0;
+}
+
+// an address list too long for one pdu is split over several messages.
+int check_addresses(ldpd::Ldpd &ldpd) {
+    ldpd::LdpFsm session = ldpd::LdpFsm(&ldpd);
+    ldpd::LdpPduPacker packer = ldpd::LdpPduPacker(&session);
+
+    ldpd::LdpAddressAdvertisement advert;
+
+    advert.ldpd = &ldpd;
+    advert.next = 0;
+
+    for (uint32_t i = 0; i < ADDRESSES; ++i) {
+        advert.addresses.push_back(htonl(0xac100000 + i));
+    }
+
+    while (advert.next < advert.addresses.size()) {
+        if (packer.add(ldpd::Ldpd::encodeAddresses, &advert) < 0) {
+            printf("addresses: add failed at %zu.\n", advert.next);
+            return 1;
+        }
+    }
+
+    if (packer.flush() < 0) {
+        printf("addresses: flush failed.\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> buffer;
+
+    if (drain(session, buffer) != 0) {
+        return 1;
+    }
+
+    std::vector<int> seen = std::vector<int>(ADDRESSES, 0);
+    int messages = 0;
+
+    int pdus = walk(buffer, [&](const ldpd::LdpMessageView &msg) {
+        ldpd::LdpTlvView addrs = msg.getTlv(LDP_TLVTYPE_ADDRESS_LIST);
+        ldpd::LdpAddressTlvValue addrs_val = ldpd::LdpAddressTlvValue();
+
+        if (msg.getType() != LDP_MSGTYPE_ADDRESS || !addrs.valid() || addrs.parseValue(addrs_val) < 0) {
+            printf("addresses: bad message.\n");
+            return 1;
+        }
+
+        for (uint32_t addr : addrs_val.getAddresses()) {
+            uint32_t i = ntohl(addr) - 0xac100000;
+
+            if (i >= ADDRESSES) {
+                printf("addresses: unexpected address.\n");
+                return 1;
+            }
+
+            ++seen[i];
+        }
+
+        ++messages;
+
+        return 0;
+    });
+
+    if (pdus < 0) {
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < ADDRESSES; ++i) {
+        if (seen[i] != 1) {
+            printf("addresses: address %u seen %d times.\n", i, seen[i]);
+            return 1;
+        }
+    }
+
+    if (messages < 2 || (size_t) messages != packer.messages()) {
+        printf("addresses: %d messages on the wire, packer says %zu.\n", messages, packer.messages());
+        return 1;
+    }
+
+    printf("addresses: %u addresses in %d messages, %d pdus, test passed.\n", ADDRESSES, messages, pdus);
+
+    return 0;
+}
+
+// a message that does not fit an empty pdu fails, and does not take what
+// was packed before it down w/ it.
+int check_oversized(ldpd::Ldpd &ldpd) {
+    ldpd::LdpFsm session = ldpd::LdpFsm(&ldpd);
+    ldpd::LdpPduPacker packer = ldpd::LdpPduPacker(&session);
+
+    ldpd::LdpLabelMapping mapping = ldpd::LdpLabelMapping();
+    mapping.fec = ldpd::Prefix(htonl(0x0a000000), 24);
+    mapping.in_label = 1000;
+
+    ldpd::LdpMappingAdvertisement advert;
+
+    advert.ldpd = &ldpd;
+    advert.mapping = &mapping;
+
+    if (packer.add(ldpd::Ldpd::encodeMapping, &advert) < 0) {
+        printf("oversized: add failed.\n");
+        return 1;
+    }
+
+    // does not fit the open pdu: that one is queued, then it does not fit
+    // the new one either.
+    if (packer.add(encode_oversized, nullptr) >= 0) {
+        printf("oversized: message bigger than a pdu was added.\n");
+        return 1;
+    }
+
+    // nothing is left in the new pdu; it must not be queued.
+    if (packer.flush() < 0 || packer.pdus() != 1 || packer.messages() != 1) {
+        printf("oversized: want 1 pdu w/ 1 message, got %zu pdus, %zu messages.\n", packer.pdus(), packer.messages());
+        return 1;
+    }
+
+    std::vector<uint8_t> buffer;
+
+    if (drain(session, buffer) != 0) {
+        return 1;
+    }
+
+    int messages = 0;
+
+    int pdus = walk(buffer, [&](const ldpd::LdpMessageView &msg) {
+        if (msg.getType() != LDP_MSGTYPE_LABEL_MAPPING || msg.getTlv(LDP_TLVTYPE_FEC).getLength() > 16) {
+            printf("oversized: unexpected message on the wire.\n");
+            return 1;
+        }
+
+        ++messages;
+
+        return 0;
+    });
+
+    if (pdus != 1 || messages != 1) {
+        printf("oversized: want 1 pdu w/ 1 message on the wire, got %d / %d.\n", pdus, messages);
+        return 1;
+    }
+
+    printf("oversized: test passed.\n");
+
+    return 0;
+}
+
+int main() {
+    NullRouter router = NullRouter();
+    ldpd::Ldpd ldpd = ldpd::Ldpd(inet_addr("10.0.0.1"), 0, &router);
+
+    ldpd.setMaxPduLength(MAX_PDU);
+
+    if (check_mappings(ldpd) != 0 || check_addresses(ldpd) != 0) {
+        return 1;
+    }
+
+    return check_oversized(ldpd);
+}
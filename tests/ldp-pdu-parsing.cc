@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include "ldp-pdu/ldp-pdu.hh"
+#include "ldp-pdu/ldp-pdu-view.hh"
 #include "ldp-tlv/ldp-tlv.hh"
+#include "ldp-tlv/ldp-fec-view.hh"
 
 #include <arpa/inet.h>
 #include <stdlib.h>
@@ -184,6 +186,85 @@ ldpd::LdpRawTlv* parse_and_writeback_tlv(const ldpd::LdpRawTlv *parsed_raw_tlv)
     return writeback_tlv;
 }
 
+int check_views(const uint8_t *buffer, size_t len, const ldpd::LdpPdu &parsed_pdu) {
+    ldpd::LdpPduView view = ldpd::LdpPduView();
+
+    if (view.parse(buffer, len) != (ssize_t) parsed_pdu.length()) {
+        printf("view parsed size mismatch.\n");
+        return 1;
+    }
+
+    if (view.getRouterId() != parsed_pdu.getRouterId() || view.getLabelSpace() != parsed_pdu.getLabelSpace()) {
+        printf("view ldp id mismatch.\n");
+        return 1;
+    }
+
+    std::vector<ldpd::LdpMessage *> msgs = parsed_pdu.getMessages();
+    size_t msg_idx = 0;
+
+    for (const ldpd::LdpMessageView msg : view) {
+        if (msg_idx >= msgs.size() || msg.getType() != msgs[msg_idx]->getType() || msg.getId() != msgs[msg_idx]->getId()) {
+            printf("view msg %zu mismatch.\n", msg_idx);
+            return 1;
+        }
+
+        std::vector<ldpd::LdpRawTlv *> tlvs = msgs[msg_idx]->getTlvs();
+        size_t tlv_idx = 0;
+
+        for (const ldpd::LdpTlvView tlv : msg) {
+            if (tlv_idx >= tlvs.size() || tlv.getType() != tlvs[tlv_idx]->getType() || tlv.size() != tlvs[tlv_idx]->length()) {
+                printf("view msg %zu tlv %zu mismatch.\n", msg_idx, tlv_idx);
+                return 1;
+            }
+
+            ++tlv_idx;
+        }
+
+        if (tlv_idx != tlvs.size()) {
+            printf("view msg %zu tlv count mismatch.\n", msg_idx);
+            return 1;
+        }
+
+        ldpd::LdpTlvView fec = msg.getTlv(LDP_TLVTYPE_FEC);
+
+        if (fec.valid()) {
+            ldpd::LdpFecTlvValue *fec_val = (ldpd::LdpFecTlvValue *) fec.getParsedValue();
+            ldpd::LdpFecView elements = ldpd::LdpFecView(fec);
+
+            uint8_t type, prelen;
+            uint32_t prefix;
+
+            for (const ldpd::LdpFecElement *el : fec_val->getElements()) {
+                if (elements.next(type, prefix, prelen) != 1 || type != el->getType()) {
+                    printf("view msg %zu fec element mismatch.\n", msg_idx);
+                    return 1;
+                }
+
+                if (type == 0x02 && (prefix != ((ldpd::LdpFecPrefixElement *) el)->getPrefix() || prelen != ((ldpd::LdpFecPrefixElement *) el)->getPrefixLength())) {
+                    printf("view msg %zu fec prefix mismatch.\n", msg_idx);
+                    return 1;
+                }
+            }
+
+            delete fec_val;
+
+            if (elements.next(type, prefix, prelen) != 0) {
+                printf("view msg %zu fec element count mismatch.\n", msg_idx);
+                return 1;
+            }
+        }
+
+        ++msg_idx;
+    }
+
+    if (msg_idx != msgs.size()) {
+        printf("view msg count mismatch.\n");
+        return 1;
+    }
+
+    return 0;
+}
+
 int parse_and_writeback(const uint8_t *buffer, size_t len) {
     ldpd::LdpPdu parsed_pdu = ldpd::LdpPdu();
 
@@ -193,6 +274,10 @@ int parse_and_writeback(const uint8_t *buffer, size_t len) {
         return 1;
     }
 
+    if (check_views(buffer, len, parsed_pdu) != 0) {
+        return 1;
+    }
+
     ldpd::LdpPdu writeback_pdu = ldpd::LdpPdu();
 
     printf("input size: %zu, parsed size: %zu\n", len, parse_rslt);
@@ -254,6 +339,86 @@ int parse_and_writeback(const uint8_t *buffer, size_t len) {
     return 0;
 }
 
+int check_tlv_roundtrip(uint16_t type, const uint8_t *value, size_t len) {
+    ldpd::LdpTlvValue *parsed = ldpd::LdpRawTlv::parseValue(type, value, len);
+
+    if (parsed == nullptr || parsed->getType() != type || parsed->length() != len) {
+        printf("tlv 0x%.4x: not parsed.\n", type);
+        return 1;
+    }
+
+    uint8_t wb[64];
+
+    if (parsed->write(wb, sizeof(wb)) != (ssize_t) len || diff(value, wb, len) != -1) {
+        printf("tlv 0x%.4x: writeback differs.\n", type);
+        delete parsed;
+        return 1;
+    }
+
+    delete parsed;
+
+    return 0;
+}
+
+int check_registry() {
+    // hop count, path vector, label request id.
+    if (check_tlv_roundtrip(LDP_TLVTYPE_HOP_COUNT, (const uint8_t *) "\x03", 1) != 0) { return 1; }
+    if (check_tlv_roundtrip(LDP_TLVTYPE_PATH_VECTOR, (const uint8_t *) "\x0a\x00\x01\x01\x0a\x00\x01\x02", 8) != 0) { return 1; }
+    if (check_tlv_roundtrip(LDP_TLVTYPE_LABEL_REQUEST, (const uint8_t *) "\x00\x00\x06\x08", 4) != 0) { return 1; }
+
+    // typed wildcard for ipv4 prefixes, then a prefix element.
+    if (check_tlv_roundtrip(LDP_TLVTYPE_FEC, (const uint8_t *) "\x05\x02\x02\x00\x01\x02\x00\x01\x18\x0a\x01\x43", 12) != 0) { return 1; }
+
+    // unknown tlv (atm label) and fec element (pwid) types.
+    if (ldpd::LdpTlvRegistry::known(LDP_TLVTYPE_ATM_LABEL) || ldpd::LdpTlvRegistry::known(LDP_TLVTYPE_FEC | 0x8000) || ldpd::LdpFecRegistry::known(0x80)) {
+        printf("unregistered type is known?\n");
+        return 1;
+    }
+
+    if (ldpd::LdpRawTlv::parseValue(LDP_TLVTYPE_FEC, (const uint8_t *) "\x03\x00", 2) != nullptr) {
+        printf("unknown fec element type parsed?\n");
+        return 1;
+    }
+
+    printf("test passed.\n");
+
+    return 0;
+}
+
+int check_parse_error(const char *name, const uint8_t *buffer, size_t len, ldpd::LdpParseErrorCode code, size_t offset) {
+    ldpd::LdpPduView view = ldpd::LdpPduView();
+    ldpd::LdpParseError err = ldpd::LdpParseError();
+
+    if (view.parse(buffer, len, &err) >= 0 || err.code != code || err.offset != offset) {
+        printf("%s: want error %d at %zu, got %d at %zu.\n", name, code, offset, err.code, err.offset);
+        return 1;
+    }
+
+    return 0;
+}
+
+int check_parse_errors() {
+    // keepalive pdu: bad version, cut short, bad message length.
+    if (check_parse_error("version", (const uint8_t *) "\x00\x02\x00\x0e\x42\x06\x06\x06\x00\x00\x02\x01\x00\x04\x00\x00\x00\x02", 18, ldpd::ParseBadVersion, 0) != 0) { return 1; }
+    if (check_parse_error("truncated", (const uint8_t *) "\x00\x01\x00\x0e\x42\x06\x06\x06\x00\x00\x02\x01\x00\x04\x00\x00\x00", 17, ldpd::ParseBadPduLength, 2) != 0) { return 1; }
+    if (check_parse_error("msg len", (const uint8_t *) "\x00\x01\x00\x0e\x42\x06\x06\x06\x00\x00\x02\x01\x00\x10\x00\x00\x00\x02", 18, ldpd::ParseBadMessageLength, 12) != 0) { return 1; }
+
+    // fec tlv w/ an ipv6 (af 2) prefix element.
+    ldpd::LdpFecView fec = ldpd::LdpFecView(ldpd::LdpTlvView((const uint8_t *) "\x01\x00\x00\x04\x02\x00\x02\x00", 8));
+    ldpd::LdpParseError err = ldpd::LdpParseError();
+    uint8_t type, prefix_len;
+    uint32_t prefix;
+
+    if (fec.next(type, prefix, prefix_len, &err) >= 0 || err.code != ldpd::ParseUnsupportedAf || err.offset != 5 || ldpd::ldpParseErrorStatus(err.code) != LDP_SC_UNSUPPORTED_AF) {
+        printf("fec: want unsupported af at 5, got %d at %zu.\n", err.code, err.offset);
+        return 1;
+    }
+
+    printf("test passed.\n");
+
+    return 0;
+}
+
 #define TEST(pdu) if (parse_and_writeback((const uint8_t *) pdu, sizeof(pdu)) != 0) { return 1; }
 
 #define KEEPALIVE_PDU "\x00\x01\x00\x0e\x42\x06\x06\x06\x00\x00\x02\x01\x00\x04\x00\x00\x00\x02"
@@ -264,6 +429,10 @@ int parse_and_writeback(const uint8_t *buffer, size_t len) {
 
 int main() {
 
+    if (check_registry() != 0 || check_parse_errors() != 0) {
+        return 1;
+    }
+
     TEST(KEEPALIVE_PDU);
     TEST(MAPPING_PDU);
     TEST(WITHDRAWAL_PDU);
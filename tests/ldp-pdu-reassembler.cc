@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <string.h>
+#include "ldp-pdu/ldp-pdu-reassembler.hh"
+
+#define KEEPALIVE_PDU "\x00\x01\x00\x0e\x42\x06\x06\x06\x00\x00\x02\x01\x00\x04\x00\x00\x00\x02"
+#define KEEPALIVE_PDU_LEN (sizeof(KEEPALIVE_PDU) - 1)
+
+// feed n keepalive pdus in chunks of chunk_sz bytes, expect n pdus out.
+int feed(size_t n, size_t chunk_sz) {
+    ldpd::LdpPduReassembler rx = ldpd::LdpPduReassembler();
+
+    size_t total = n * KEEPALIVE_PDU_LEN;
+    uint8_t *stream = new uint8_t[total];
+
+    for (size_t i = 0; i < n; ++i) {
+        memcpy(stream + i * KEEPALIVE_PDU_LEN, KEEPALIVE_PDU, KEEPALIVE_PDU_LEN);
+    }
+
+    size_t fed = 0, got = 0;
+
+    while (fed < total) {
+        size_t avail;
+        uint8_t *ptr = rx.prepare(avail);
+
+        size_t len = total - fed;
+        len = len > chunk_sz ? chunk_sz : len;
+        len = len > avail ? avail : len;
+
+        memcpy(ptr, stream + fed, len);
+        rx.commit(len);
+        fed += len;
+
+        const uint8_t *pdu;
+        size_t pdu_len;
+        int rslt;
+
+        while ((rslt = rx.next(pdu, pdu_len)) == LDP_REASM_PDU) {
+            if (pdu_len != KEEPALIVE_PDU_LEN || memcmp(pdu, KEEPALIVE_PDU, pdu_len) != 0) {
+                printf("chunk %zu: pdu %zu mismatch.\n", chunk_sz, got);
+                delete[] stream;
+                return 1;
+            }
+
+            ++got;
+        }
+
+        if (rslt != LDP_REASM_NEED_MORE) {
+            printf("chunk %zu: unexpected result %d.\n", chunk_sz, rslt);
+            delete[] stream;
+            return 1;
+        }
+    }
+
+    delete[] stream;
+
+    if (got != n || rx.pending() != 0) {
+        printf("chunk %zu: got %zu of %zu pdus, %zu bytes left.\n", chunk_sz, got, n, rx.pending());
+        return 1;
+    }
+
+    printf("chunk %zu: test passed (buffer grew to %zu).\n", chunk_sz, rx.capacity());
+
+    return 0;
+}
+
+int bad_length() {
+    ldpd::LdpPduReassembler rx = ldpd::LdpPduReassembler();
+
+    size_t avail;
+    uint8_t *ptr = rx.prepare(avail);
+
+    memcpy(ptr, "\x00\x01\x00\x02", 4);
+    rx.commit(4);
+
+    const uint8_t *pdu;
+    size_t pdu_len;
+
+    if (rx.next(pdu, pdu_len) != LDP_REASM_BAD_LENGTH) {
+        printf("bad length not detected.\n");
+        return 1;
+    }
+
+    printf("bad length: test passed.\n");
+
+    return 0;
+}
+
+int main() {
+    if (feed(10000, 1) != 0) return 1;
+    if (feed(10000, 7) != 0) return 1;
+    if (feed(10000, 18) != 0) return 1;
+    if (feed(10000, 65536) != 0) return 1;
+    if (bad_length() != 0) return 1;
+
+    return 0;
+}
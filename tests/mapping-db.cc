@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <arpa/inet.h>
+#include "core/mapping-db.hh"
+
+static ldpd::LdpLabelMapping make_mapping(uint32_t n, uint32_t out_label) {
+    ldpd::LdpLabelMapping mapping = ldpd::LdpLabelMapping();
+
+    mapping.remote = true;
+    mapping.fec = ldpd::Prefix(htonl(0x0a000000 + (n << 8)), 24);
+    mapping.out_label = out_label;
+
+    return mapping;
+}
+
+// one binding per (peer, fec); a repeated mapping updates it in place.
+int check_update() {
+    ldpd::MappingDb db = ldpd::MappingDb();
+    ldpd::LdpLabelMapping mapping = make_mapping(1, 100);
+
+    ldpd::LdpLabelMapping *added = db.update(1, mapping);
+    added->in_label = 16;
+
+    mapping.out_label = 200;
+
+    if (db.update(1, mapping) != added || db.size() != 1) {
+        printf("update: binding not updated in place.\n");
+        return 1;
+    }
+
+    if (added->out_label != 200 || added->in_label != 16) {
+        printf("update: want out 200 in 16, got out %u in %u.\n", added->out_label, added->in_label);
+        return 1;
+    }
+
+    db.update(2, mapping);
+
+    const std::vector<uint64_t> *peers = db.getPeers(mapping.fec);
+
+    if (db.size() != 2 || peers == nullptr || peers->size() != 2 || (*peers)[0] != 1 || (*peers)[1] != 2) {
+        printf("update: bad fec index.\n");
+        return 1;
+    }
+
+    printf("update: test passed.\n");
+
+    return 0;
+}
+
+// removing the binding in use clears it; the fec goes away w/ its last binding.
+int check_remove() {
+    ldpd::MappingDb db = ldpd::MappingDb();
+    ldpd::LdpLabelMapping mapping = make_mapping(1, 100);
+
+    db.update(1, mapping);
+    db.update(2, mapping);
+    db.setActive(mapping.fec, 1);
+
+    if (db.remove(3, mapping.fec) == 0 || db.remove(1, make_mapping(2, 0).fec) == 0) {
+        printf("remove: removed a binding that does not exist.\n");
+        return 1;
+    }
+
+    if (db.remove(1, mapping.fec) != 0 || db.getActive(mapping.fec) != 0 || db.find(1, mapping.fec) != nullptr) {
+        printf("remove: binding still there.\n");
+        return 1;
+    }
+
+    if (db.find(2, mapping.fec) == nullptr || db.getPeers(mapping.fec)->size() != 1) {
+        printf("remove: other peer's binding gone.\n");
+        return 1;
+    }
+
+    db.remove(2, mapping.fec);
+
+    if (db.getPeers(mapping.fec) != nullptr || db.size() != 0 || !db.hasPeer(2)) {
+        printf("remove: bad state after removing the last binding.\n");
+        return 1;
+    }
+
+    printf("remove: test passed.\n");
+
+    return 0;
+}
+
+// bindings are identified by fec and direction; labels do not matter.
+int check_identity() {
+    // remote bindings for two fecs, w/ the same label (so the same label sum).
+    const ldpd::LdpLabelMapping first = make_mapping(1, 100);
+    const ldpd::LdpLabelMapping second = make_mapping(2, 100);
+
+    ldpd::LdpLabelMapping first_local = first;
+    first_local.remote = false;
+    first_local.in_label = first.out_label;
+    first_local.out_label = 0;
+
+    ldpd::LdpLabelMapping first_relabeled = first;
+    first_relabeled.out_label = 200;
+    first_relabeled.in_label = 16;
+
+    ldpd::LdpLabelMappingSet set = ldpd::LdpLabelMappingSet();
+
+    set.insert(first);
+    set.insert(second);
+    set.insert(first_local);
+
+    if (set.size() != 3) {
+        printf("identity: want 3 bindings, got %zu.\n", set.size());
+        return 1;
+    }
+
+    if (set.count(first_relabeled) != 1 || !(first == first_relabeled) || first < first_relabeled || first_relabeled < first) {
+        printf("identity: label is part of the identity.\n");
+        return 1;
+    }
+
+    if (!(first_local < first) || !(first < second)) {
+        printf("identity: bad ordering.\n");
+        return 1;
+    }
+
+    printf("identity: test passed.\n");
+
+    return 0;
+}
+
+int main() {
+    if (check_update() != 0 || check_remove() != 0 || check_identity() != 0) {
+        return 1;
+    }
+
+    return 0;
+}
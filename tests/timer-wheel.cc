@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <vector>
+#include "core/timer-wheel.hh"
+
+// a timer that records when it fired. if rearm is set, the handler arms the
+// timer again, period ticks later, until rearm runs out.
+struct Probe {
+    Probe() {
+        wheel = nullptr;
+        deadline = 0;
+        fired_at = 0;
+        fires = 0;
+        late = 0;
+        period = 0;
+        rearm = 0;
+    }
+
+    ldpd::TimerWheel *wheel;
+    ldpd::Timer timer;
+
+    uint64_t deadline;
+    uint64_t fired_at;
+    int fires;
+
+    // fires not at the deadline.
+    int late;
+
+    uint64_t period;
+    int rearm;
+};
+
+static void handle_probe(void *data) {
+    Probe *probe = (Probe *) data;
+
+    probe->fired_at = probe->wheel->now();
+    ++probe->fires;
+
+    if (probe->fired_at != probe->deadline) {
+        ++probe->late;
+    }
+
+    if (probe->rearm > 0) {
+        --probe->rearm;
+        probe->deadline = probe->fired_at + probe->period;
+        probe->wheel->schedule(&probe->timer, probe->deadline);
+    }
+}
+
+static void arm(ldpd::TimerWheel &wheel, Probe &probe, uint64_t deadline) {
+    probe.wheel = &wheel;
+    probe.deadline = deadline;
+    probe.timer.setHandler(handle_probe, &probe);
+    wheel.schedule(&probe.timer, deadline);
+}
+
+static uint64_t rand_state = 0x2545f4914f6cdd1dULL;
+
+static uint64_t next_rand() {
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 7;
+    rand_state ^= rand_state << 17;
+
+    return rand_state;
+}
+
+// timers on every level move down and fire at their deadline, however far
+// advance() jumps at once.
+int check_cascade() {
+    const uint64_t start = 1000;
+    const uint64_t offsets[] = {
+        0, 1, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 262145,
+        (1ULL << 24) - 1, 1ULL << 24, (1ULL << 30) + 7, (1ULL << 36) - 1
+    };
+    const size_t count = sizeof(offsets) / sizeof(offsets[0]);
+
+    // once in a single jump, once in small random steps.
+    for (int stepped = 0; stepped < 2; ++stepped) {
+        ldpd::TimerWheel wheel = ldpd::TimerWheel(start);
+        std::vector<Probe> probes = std::vector<Probe>(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            arm(wheel, probes[i], start + offsets[i]);
+        }
+
+        uint64_t end = start + offsets[count - 1];
+
+        if (!stepped) {
+            wheel.advance(end);
+        } else {
+            while (wheel.now() < end) {
+                uint64_t next = wheel.nextEvent();
+                uint64_t step = wheel.now() + 1 + next_rand() % 100000;
+
+                wheel.advance(next != TIMER_WHEEL_NEVER && next < step ? next : step);
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (probes[i].fires != 1 || probes[i].late != 0) {
+                printf("cascade: timer +%lu fired %d times, last at +%lu.\n", (unsigned long) offsets[i], probes[i].fires, (unsigned long) (probes[i].fired_at - start));
+                return 1;
+            }
+        }
+
+        if (wheel.nextEvent() != TIMER_WHEEL_NEVER) {
+            printf("cascade: timers left after all fired.\n");
+            return 1;
+        }
+    }
+
+    printf("cascade: test passed.\n");
+
+    return 0;
+}
+
+// deadlines beyond what the wheel covers wait at the top level and still fire
+// on time.
+int check_far() {
+    ldpd::TimerWheel wheel = ldpd::TimerWheel(12345);
+    Probe probes[3];
+
+    arm(wheel, probes[0], 12345 + (1ULL << 36) + 1);
+    arm(wheel, probes[1], 12345 + (3ULL << 36) + 777);
+    arm(wheel, probes[2], 12345 + (1ULL << 40));
+
+    wheel.advance(12345 + (1ULL << 36));
+
+    if (probes[0].fires != 0) {
+        printf("far: timer fired early.\n");
+        return 1;
+    }
+
+    // walk the events one by one, as the daemon's loop does.
+    while (wheel.nextEvent() != TIMER_WHEEL_NEVER) {
+        uint64_t next = wheel.nextEvent();
+
+        if (next < wheel.now()) {
+            printf("far: next event %lu is before now %lu.\n", (unsigned long) next, (unsigned long) wheel.now());
+            return 1;
+        }
+
+        wheel.advance(next);
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        if (probes[i].fires != 1 || probes[i].late != 0) {
+            printf("far: timer %d fired %d times at %lu, want once at %lu.\n", i, probes[i].fires, (unsigned long) probes[i].fired_at, (unsigned long) probes[i].deadline);
+            return 1;
+        }
+    }
+
+    printf("far: test passed.\n");
+
+    return 0;
+}
+
+// a handler re-arming its own timer, later or due right away.
+int check_rearm() {
+    ldpd::TimerWheel wheel = ldpd::TimerWheel(0);
+    Probe periodic, immediate;
+
+    periodic.period = 1000;
+    periodic.rearm = 99;
+    arm(wheel, periodic, 1000);
+
+    immediate.period = 0;
+    immediate.rearm = 5;
+    arm(wheel, immediate, 5000);
+
+    for (uint64_t now = 0; now <= 200000; now += 777) {
+        wheel.advance(now);
+    }
+
+    if (periodic.fires != 100 || periodic.late != 0 || periodic.fired_at != 100000 || periodic.timer.armed()) {
+        printf("rearm: periodic timer fired %d times (%d late), last at %lu.\n", periodic.fires, periodic.late, (unsigned long) periodic.fired_at);
+        return 1;
+    }
+
+    if (immediate.fires != 6 || immediate.late != 0 || immediate.fired_at != 5000) {
+        printf("rearm: timer re-armed for now fired %d times, last at %lu.\n", immediate.fires, (unsigned long) immediate.fired_at);
+        return 1;
+    }
+
+    printf("rearm: test passed.\n");
+
+    return 0;
+}
+
+// a timer canceled after it was moved down a level does not fire, and leaves
+// nothing behind.
+int check_cancel() {
+    ldpd::TimerWheel wheel = ldpd::TimerWheel(0);
+    Probe canceled, kept;
+
+    arm(wheel, canceled, 300000);
+    arm(wheel, kept, 300001);
+
+    // into the level 0 block of the deadlines: both got cascaded down.
+    wheel.advance(299990);
+
+    if (canceled.fires != 0 || !canceled.timer.armed()) {
+        printf("cancel: timer fired early.\n");
+        return 1;
+    }
+
+    wheel.cancel(&canceled.timer);
+
+    if (canceled.timer.armed() || wheel.nextEvent() != 300001) {
+        printf("cancel: timer still armed, next event %lu.\n", (unsigned long) wheel.nextEvent());
+        return 1;
+    }
+
+    // canceling twice does nothing.
+    wheel.cancel(&canceled.timer);
+
+    wheel.advance(400000);
+
+    if (canceled.fires != 0 || kept.fires != 1 || kept.late != 0 || wheel.nextEvent() != TIMER_WHEEL_NEVER) {
+        printf("cancel: canceled fired %d times, kept %d times.\n", canceled.fires, kept.fires);
+        return 1;
+    }
+
+    printf("cancel: test passed.\n");
+
+    return 0;
+}
+
+// random deadlines, random jumps, random cancels and reschedules: every
+// timer still armed fires once, at its deadline; nextEvent() is never past
+// the earliest deadline.
+int check_random() {
+    const size_t count = 2000;
+
+    ldpd::TimerWheel wheel = ldpd::TimerWheel(next_rand() % 1000000);
+    std::vector<Probe> probes = std::vector<Probe>(count);
+    std::vector<bool> live = std::vector<bool>(count, true);
+
+    for (size_t i = 0; i < count; ++i) {
+        // spread over all levels.
+        uint64_t range = 1ULL << (next_rand() % 38);
+        arm(wheel, probes[i], wheel.now() + next_rand() % range);
+    }
+
+    while (wheel.nextEvent() != TIMER_WHEEL_NEVER) {
+        uint64_t earliest = TIMER_WHEEL_NEVER;
+
+        for (size_t i = 0; i < count; ++i) {
+            if (live[i] && probes[i].fires == 0 && probes[i].deadline < earliest) {
+                earliest = probes[i].deadline;
+            }
+        }
+
+        uint64_t next = wheel.nextEvent();
+
+        if (next > earliest || next < wheel.now()) {
+            printf("random: next event %lu, earliest deadline %lu, now %lu.\n", (unsigned long) next, (unsigned long) earliest, (unsigned long) wheel.now());
+            return 1;
+        }
+
+        // jump past several slots at once, sometimes past the next event.
+        uint64_t jump = next_rand() % 4 == 0 ? next_rand() % (1ULL << (next_rand() % 30)) : 0;
+        wheel.advance(next + jump);
+
+        size_t pick = next_rand() % count;
+
+        if (live[pick] && probes[pick].fires == 0) {
+            if (next_rand() % 2 == 0) {
+                wheel.cancel(&probes[pick].timer);
+                live[pick] = false;
+            } else {
+                probes[pick].deadline = wheel.now() + next_rand() % (1ULL << (next_rand() % 38));
+                wheel.schedule(&probes[pick].timer, probes[pick].deadline);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        int want = live[i] ? 1 : 0;
+
+        if (probes[i].fires != want || probes[i].late != 0) {
+            printf("random: timer %zu fired %d times (want %d), at %lu for %lu.\n", i, probes[i].fires, want, (unsigned long) probes[i].fired_at, (unsigned long) probes[i].deadline);
+            return 1;
+        }
+    }
+
+    printf("random: test passed.\n");
+
+    return 0;
+}
+
+int main() {
+    if (check_cascade() != 0 || check_far() != 0 || check_rearm() != 0 || check_cancel() != 0) {
+        return 1;
+    }
+
+    return check_random();
+}